@@ -0,0 +1,258 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "AllocTracker.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GNUC__)
+// The hooks may run while a thread's TLS is being set up; initial-exec access never allocates.
+#define ALLOC_TLS __attribute__((tls_model("initial-exec")))
+#else
+#define ALLOC_TLS
+#endif
+
+namespace {
+
+struct Counter {
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> bytes;
+};
+
+// Zero-initialized before anything runs, so allocations during static initialization are safe.
+Counter s_counters[MAX_ALLOC_THREADS][(int) AllocPhase::Count];
+std::atomic<int> s_threadCount(0);
+
+thread_local int t_slot ALLOC_TLS = -1;
+thread_local int t_phase ALLOC_TLS = (int) AllocPhase::Other;
+
+}
+
+std::atomic<bool> AllocTracker::s_enabled(false);
+
+void AllocTracker::start() {
+    s_enabled.store(true, std::memory_order_relaxed);
+}
+
+void AllocTracker::stop() {
+    s_enabled.store(false, std::memory_order_relaxed);
+}
+
+void AllocTracker::reset() {
+    for(auto &thread : s_counters) {
+        for(Counter &counter : thread) {
+            counter.allocations.store(0, std::memory_order_relaxed);
+            counter.bytes.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void AllocTracker::count(uint64_t bytes) {
+    if(!isEnabled()) {
+        return;
+    }
+
+    if(t_slot < 0) {
+        t_slot = std::min(s_threadCount.fetch_add(1, std::memory_order_relaxed), MAX_ALLOC_THREADS - 1);
+    }
+
+    // Only shared once slots run out, so the atomics are uncontended.
+    Counter &counter = s_counters[t_slot][t_phase];
+    counter.allocations.fetch_add(1, std::memory_order_relaxed);
+    counter.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+AllocPhase AllocTracker::setPhase(AllocPhase phase) {
+    AllocPhase previous = (AllocPhase) t_phase;
+    t_phase = (int) phase;
+    return previous;
+}
+
+AllocCounts AllocTracker::getCounts(AllocPhase phase) {
+    AllocCounts total;
+    for(int thread = 0; thread < getThreadCount(); thread++) {
+        AllocCounts counts = getThreadCounts(thread, phase);
+        total.allocations += counts.allocations;
+        total.bytes += counts.bytes;
+    }
+    return total;
+}
+
+AllocCounts AllocTracker::getThreadCounts(int thread, AllocPhase phase) {
+    const Counter &counter = s_counters[thread][(int) phase];
+    AllocCounts counts;
+    counts.allocations = counter.allocations.load(std::memory_order_relaxed);
+    counts.bytes = counter.bytes.load(std::memory_order_relaxed);
+    return counts;
+}
+
+int AllocTracker::getThreadCount() {
+    return std::min(s_threadCount.load(std::memory_order_relaxed), MAX_ALLOC_THREADS);
+}
+
+const char *AllocTracker::getPhaseName(AllocPhase phase) {
+    switch(phase) {
+        case AllocPhase::Setup:
+            return "setup";
+        case AllocPhase::Tree:
+            return "tree";
+        case AllocPhase::Report:
+            return "report";
+        default:
+            return "other";
+    }
+}
+
+bool AllocTracker::isCompiledIn() {
+#ifdef OTHELLO_ALLOC_TRACK
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef OTHELLO_ALLOC_TRACK
+
+// glibc exports its allocator under these names, so malloc itself can be replaced and forwarded.
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size) {
+    AllocTracker::count(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    AllocTracker::count(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    AllocTracker::count(size);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+}
+
+#define ALLOC_RAW_MALLOC __libc_malloc
+#else
+#define ALLOC_RAW_MALLOC std::malloc
+#endif
+
+namespace {
+
+// Counted here rather than in malloc, which is not hooked everywhere.
+void *trackedNew(size_t size, bool nothrow) {
+    AllocTracker::count(size);
+    void *ptr = ALLOC_RAW_MALLOC(size == 0 ? 1 : size);
+    if(ptr == nullptr && !nothrow) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *trackedAlignedNew(size_t size, std::align_val_t align, bool nothrow) {
+    AllocTracker::count(size);
+    size_t alignment = std::max((size_t) align, sizeof(void *));
+    // aligned_alloc wants a multiple of the alignment.
+    size_t rounded = (std::max(size, (size_t) 1) + alignment - 1) / alignment * alignment;
+    void *ptr = std::aligned_alloc(alignment, rounded);
+    if(ptr == nullptr && !nothrow) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+}
+
+void *operator new(size_t size) {
+    return trackedNew(size, false);
+}
+
+void *operator new[](size_t size) {
+    return trackedNew(size, false);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    return trackedNew(size, true);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    return trackedNew(size, true);
+}
+
+void *operator new(size_t size, std::align_val_t align) {
+    return trackedAlignedNew(size, align, false);
+}
+
+void *operator new[](size_t size, std::align_val_t align) {
+    return trackedAlignedNew(size, align, false);
+}
+
+void *operator new(size_t size, std::align_val_t align, const std::nothrow_t &) noexcept {
+    return trackedAlignedNew(size, align, true);
+}
+
+void *operator new[](size_t size, std::align_val_t align, const std::nothrow_t &) noexcept {
+    return trackedAlignedNew(size, align, true);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+#endif
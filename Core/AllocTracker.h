@@ -0,0 +1,121 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_ALLOCTRACKER_H
+#define OTHELLOPROJECT_CPP_ALLOCTRACKER_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * What the allocating thread was doing, as marked with ALLOC_PHASE.
+ */
+enum class AllocPhase {
+    Other,
+    /**
+     * selectMove outside of the tree search: root move generation, limits, bookkeeping.
+     */
+    Setup,
+    /**
+     * The alpha-beta tree below the root. Must not allocate.
+     */
+    Tree,
+    /**
+     * Per-iteration output: lines, iteration callbacks and log comments.
+     */
+    Report,
+    Count
+};
+
+struct AllocCounts {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+/**
+ * Heap allocation counter for finding and keeping allocations out of the search.
+ *
+ * With OTHELLO_ALLOC_TRACK defined, the global operator new (every form) is replaced, and on glibc
+ * so are malloc, calloc and realloc. Once start() has been called, every allocation is counted
+ * against the calling thread and its current AllocPhase. Counting takes no lock and never
+ * allocates. Threads get a slot in the order they first allocate; past MAX_ALLOC_THREADS they
+ * share the last one.
+ *
+ * Without OTHELLO_ALLOC_TRACK nothing is hooked, ALLOC_PHASE compiles away and all counts stay 0.
+ */
+#define MAX_ALLOC_THREADS 64
+
+class AllocTracker {
+public:
+    /**
+     * Starts counting. Counts so far are kept.
+     */
+    static void start();
+    static void stop();
+    static inline bool isEnabled() {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+    /**
+     * Zeroes all counts. Thread slots stay assigned.
+     */
+    static void reset();
+    /**
+     * Counts one allocation for the calling thread. Called by the hooks.
+     */
+    static void count(uint64_t bytes);
+    /**
+     * Marks what the calling thread is doing from now on.
+     * @return The previous phase.
+     */
+    static AllocPhase setPhase(AllocPhase phase);
+    /**
+     * @return Counts for phase, summed over all threads.
+     */
+    static AllocCounts getCounts(AllocPhase phase);
+    /**
+     * @param thread Slot, below getThreadCount().
+     */
+    static AllocCounts getThreadCounts(int thread, AllocPhase phase);
+    /**
+     * @return Number of thread slots in use.
+     */
+    static int getThreadCount();
+    static const char *getPhaseName(AllocPhase phase);
+    /**
+     * @return True if this build counts allocations, i.e. OTHELLO_ALLOC_TRACK is defined.
+     */
+    static bool isCompiledIn();
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * Sets the calling thread's phase for the lifetime of a scope.
+ */
+class AllocPhaseScope {
+public:
+    explicit AllocPhaseScope(AllocPhase phase) : m_previous(AllocTracker::setPhase(phase)) {}
+
+    ~AllocPhaseScope() {
+        AllocTracker::setPhase(m_previous);
+    }
+
+    AllocPhaseScope(const AllocPhaseScope &) = delete;
+    AllocPhaseScope &operator=(const AllocPhaseScope &) = delete;
+
+private:
+    AllocPhase m_previous;
+};
+
+#define ALLOC_CONCAT_INNER(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_INNER(a, b)
+
+#ifdef OTHELLO_ALLOC_TRACK
+#define ALLOC_PHASE(phase) AllocPhaseScope ALLOC_CONCAT(allocPhase, __LINE__)(phase)
+#else
+#define ALLOC_PHASE(phase) do { } while(0)
+#endif
+
+#endif //OTHELLOPROJECT_CPP_ALLOCTRACKER_H
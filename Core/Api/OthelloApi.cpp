@@ -0,0 +1,165 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "OthelloApi.h"
+#include "OthelloEngine.h"
+
+struct othello_engine {
+    OthelloEngine engine;
+    othello_stop_fn stop = nullptr;
+    void *stopUser = nullptr;
+    othello_info_fn info = nullptr;
+    void *infoUser = nullptr;
+
+    explicit othello_engine(const EngineOptions &options) : engine(options) {}
+};
+
+namespace {
+
+bool callStop(void *user) {
+    othello_engine *handle = (othello_engine *) user;
+    return handle->stop(handle->stopUser) != 0;
+}
+
+void callInfo(const SearchInfo &info, const int *pv, int pvLength, void *user) {
+    othello_engine *handle = (othello_engine *) user;
+    handle->info(info.depth, info.line, info.score, info.nodes, info.timeMs, pv, pvLength, handle->infoUser);
+}
+
+}
+
+othello_engine *othello_create(int engine, int threads, int game_time) {
+    EngineOptions options;
+    options.engine = engine == OTHELLO_ENGINE_MCTS ? EngineType::Mcts : EngineType::AlphaBeta;
+    options.threads = threads;
+    if(game_time > 0) {
+        options.gameTime = game_time;
+    }
+
+    try {
+        return new othello_engine(options);
+    } catch(...) {
+        return nullptr;
+    }
+}
+
+void othello_destroy(othello_engine *engine) {
+    delete engine;
+}
+
+void othello_new_game(othello_engine *engine) {
+    engine->engine.newGame();
+}
+
+int othello_set_position(othello_engine *engine, uint64_t black, uint64_t white, int side_to_move) {
+    return engine->engine.setPosition(black, white, side_to_move);
+}
+
+uint64_t othello_get_black(const othello_engine *engine) {
+    return engine->engine.getBlack();
+}
+
+uint64_t othello_get_white(const othello_engine *engine) {
+    return engine->engine.getWhite();
+}
+
+int othello_get_side_to_move(const othello_engine *engine) {
+    return engine->engine.getSideToMove();
+}
+
+uint64_t othello_legal_moves(const othello_engine *engine) {
+    return engine->engine.getLegalMoves();
+}
+
+int othello_play(othello_engine *engine, int move) {
+    return engine->engine.play(move);
+}
+
+int othello_is_game_over(const othello_engine *engine) {
+    return engine->engine.isGameOver();
+}
+
+int othello_search(othello_engine *engine, const othello_limits *limits, othello_result *result) {
+    SearchLimits searchLimits;
+    if(limits != nullptr) {
+        searchLimits.moveTimeMs = limits->move_time_ms;
+        searchLimits.depth = limits->depth;
+        searchLimits.nodes = limits->nodes;
+        searchLimits.infinite = limits->infinite != 0;
+        searchLimits.multiPv = limits->multi_pv;
+    }
+
+    try {
+        EngineResult found = engine->engine.search(searchLimits);
+
+        result->move = found.move;
+        result->score = found.score;
+        result->depth = found.depth;
+        result->nodes = found.nodes;
+        result->time_ms = found.timeMs;
+        result->pv_length = found.pvLength < OTHELLO_MAX_PV ? found.pvLength : OTHELLO_MAX_PV;
+        for(int i = 0; i < result->pv_length; i++) {
+            result->pv[i] = found.pv[i];
+        }
+        return 1;
+    } catch(...) {
+        return 0;
+    }
+}
+
+void othello_stop(othello_engine *engine) {
+    engine->engine.stop();
+}
+
+void othello_set_stop_callback(othello_engine *engine, othello_stop_fn callback, void *user) {
+    engine->stop = callback;
+    engine->stopUser = user;
+    engine->engine.setStopCallback(callback != nullptr ? callStop : nullptr, engine);
+}
+
+void othello_set_info_callback(othello_engine *engine, othello_info_fn callback, void *user) {
+    engine->info = callback;
+    engine->infoUser = user;
+    engine->engine.setIterationCallback(callback != nullptr ? callInfo : nullptr, engine);
+}
+
+int othello_evaluate(const othello_engine *engine) {
+    try {
+        return engine->engine.evaluate();
+    } catch(...) {
+        return 0;
+    }
+}
+
+int othello_load_hash(othello_engine *engine, const char *path, int read_only) {
+    try {
+        return engine->engine.loadHash(path, read_only != 0);
+    } catch(...) {
+        return 0;
+    }
+}
+
+int othello_save_hash(const othello_engine *engine, const char *path) {
+    try {
+        return engine->engine.saveHash(path);
+    } catch(...) {
+        return 0;
+    }
+}
+
+void othello_clear_hash(othello_engine *engine) {
+    engine->engine.clearHash();
+}
+
+int othello_load_network(const char *path) {
+    try {
+        return OthelloEngine::loadNetwork(path);
+    } catch(...) {
+        return 0;
+    }
+}
+
+void othello_set_log_callback(othello_log_fn callback, void *user) {
+    OthelloEngine::setLogSink(callback, user);
+}
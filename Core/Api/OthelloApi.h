@@ -0,0 +1,98 @@
+/*
+ * Created by hburn7 on 10/19/26.
+ *
+ * C interface to the engine, a thin layer over OthelloEngine. Functions never throw and never
+ * write to stdout. Bitboards use the engine layout (H8 = bit 0, A1 = bit 63); colors are
+ * OTHELLO_BLACK and OTHELLO_WHITE; a move is a board position 0-63, or -1 for a pass.
+ */
+
+#ifndef OTHELLOPROJECT_CPP_OTHELLOAPI_H
+#define OTHELLOPROJECT_CPP_OTHELLOAPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OTHELLO_BLACK (-1)
+#define OTHELLO_WHITE 1
+
+#define OTHELLO_ENGINE_ALPHABETA 0
+#define OTHELLO_ENGINE_MCTS 1
+
+#define OTHELLO_MAX_PV 64
+
+typedef struct othello_engine othello_engine;
+
+/* Zero means "not set" for every field. With nothing set, the move time is game_time / 30.
+ * multi_pv > 1 searches that many best moves with exact scores; each is reported to the info callback. */
+typedef struct othello_limits {
+    int64_t move_time_ms;
+    int depth;
+    uint64_t nodes;
+    int infinite;
+    int multi_pv;
+} othello_limits;
+
+typedef struct othello_result {
+    int move;
+    int score;
+    int depth;
+    uint64_t nodes;
+    uint64_t time_ms;
+    int pv_length;
+    int pv[OTHELLO_MAX_PV];
+} othello_result;
+
+/* Returns nonzero to stop the search. May be called from a search thread. */
+typedef int (*othello_stop_fn)(void *user);
+/* Receives every line (1 = best, up to multi_pv) of every completed iteration of an alpha-beta search,
+ * on the searching thread. */
+typedef void (*othello_info_fn)(int depth, int line, int score, uint64_t nodes, uint64_t time_ms, const int *pv,
+                                int pv_length, void *user);
+/* Receives one log line (not NUL-terminated) from the logger's background thread. */
+typedef void (*othello_log_fn)(const char *text, size_t length, void *user);
+
+/* Returns NULL on failure. threads = 0 uses one thread per core. game_time is in seconds. */
+othello_engine *othello_create(int engine, int threads, int game_time);
+void othello_destroy(othello_engine *engine);
+
+void othello_new_game(othello_engine *engine);
+/* Returns 0 if the position is invalid. */
+int othello_set_position(othello_engine *engine, uint64_t black, uint64_t white, int side_to_move);
+uint64_t othello_get_black(const othello_engine *engine);
+uint64_t othello_get_white(const othello_engine *engine);
+int othello_get_side_to_move(const othello_engine *engine);
+
+uint64_t othello_legal_moves(const othello_engine *engine);
+/* Returns 0 if the move is illegal. */
+int othello_play(othello_engine *engine, int move);
+int othello_is_game_over(const othello_engine *engine);
+
+/* limits may be NULL. Returns 0 on failure. */
+int othello_search(othello_engine *engine, const othello_limits *limits, othello_result *result);
+/* Safe to call from any thread. */
+void othello_stop(othello_engine *engine);
+void othello_set_stop_callback(othello_engine *engine, othello_stop_fn callback, void *user);
+void othello_set_info_callback(othello_engine *engine, othello_info_fn callback, void *user);
+/* Static evaluation from the side to move's point of view. */
+int othello_evaluate(const othello_engine *engine);
+
+/* Transposition table snapshots. Loading maps the file; read_only shares it between processes
+ * and stops the engine from storing new results. Return 0 on failure. */
+int othello_load_hash(othello_engine *engine, const char *path, int read_only);
+int othello_save_hash(const othello_engine *engine, const char *path);
+void othello_clear_hash(othello_engine *engine);
+
+/* Returns 0 if the network could not be loaded. */
+int othello_load_network(const char *path);
+/* Log output is dropped unless a callback is set. Pass NULL to drop it again. */
+void othello_set_log_callback(othello_log_fn callback, void *user);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTHELLOPROJECT_CPP_OTHELLOAPI_H */
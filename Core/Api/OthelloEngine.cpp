@@ -0,0 +1,212 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "OthelloEngine.h"
+
+#include <atomic>
+
+#include "../Eval/Nnue.h"
+#include "../OthelloGame/OthelloGameBoard.h"
+#include "../Search/DfpnSolver.h"
+#include "../Search/Mcts.h"
+
+#define BLACK_START 0x0000000810000000ULL
+#define WHITE_START 0x0000001008000000ULL
+
+namespace {
+
+// Set once the embedder has chosen where log output goes.
+std::atomic<bool> g_sinkChosen(false);
+
+}
+
+OthelloEngine::OthelloEngine(const EngineOptions &options) :
+        m_cfg(false, options.gameTime), m_black(BLACK_START), m_white(WHITE_START), m_sideToMove(BLACK),
+        m_ctx(std::make_unique<SearchContext>()), m_tt(std::make_unique<TranspositionTable>(options.hashMb)) {
+    // The engine logs as if it were talking to the referee. Unless told otherwise, drop all of it.
+    if(options.quiet && !g_sinkChosen.exchange(true)) {
+        Logger::setSink(Logger::discard, nullptr);
+        Logger::setLevel(LogLevel::Off);
+    }
+
+    m_cfg.setEngine(options.engine);
+    m_cfg.setThreads(options.threads);
+    m_cfg.setHashMb(options.hashMb);
+    m_ctx->setTable(m_tt.get());
+    m_ctx->setParams(options.searchParams);
+    m_cfg.setSearchParams(options.searchParams);
+    if(options.engine == EngineType::Mcts) {
+        m_mcts = std::make_unique<Mcts>(MCTS_DEFAULT_NODES, options.threads);
+    } else {
+        m_solver = std::make_unique<DfpnSolver>();
+        m_ctx->setSolver(m_solver.get());
+    }
+}
+
+OthelloEngine::~OthelloEngine() = default;
+
+void OthelloEngine::newGame() {
+    m_black = BLACK_START;
+    m_white = WHITE_START;
+    m_sideToMove = BLACK;
+}
+
+bool OthelloEngine::setPosition(uint64_t black, uint64_t white, int sideToMove) {
+    if((black & white) != 0 || (sideToMove != BLACK && sideToMove != WHITE)) {
+        return false;
+    }
+
+    m_black = black;
+    m_white = white;
+    m_sideToMove = sideToMove;
+    return true;
+}
+
+uint64_t OthelloEngine::getBlack() const {
+    return m_black;
+}
+
+uint64_t OthelloEngine::getWhite() const {
+    return m_white;
+}
+
+int OthelloEngine::getSideToMove() const {
+    return m_sideToMove;
+}
+
+uint64_t OthelloEngine::getLegalMoves() const {
+    return m_sideToMove == BLACK ? OthelloGameBoard::generateMoveMask(m_black, m_white)
+                                 : OthelloGameBoard::generateMoveMask(m_white, m_black);
+}
+
+bool OthelloEngine::play(int pos) {
+    uint64_t legal = this->getLegalMoves();
+
+    if(pos == -1) {
+        if(legal != 0) {
+            return false;
+        }
+    } else {
+        if(pos < 0 || pos > 63 || (legal & (1ULL << pos)) == 0) {
+            return false;
+        }
+
+        uint64_t &player = m_sideToMove == BLACK ? m_black : m_white;
+        uint64_t &opponent = m_sideToMove == BLACK ? m_white : m_black;
+        uint64_t flips = OthelloGameBoard::getFlips(player, opponent, pos);
+
+        player |= flips | (1ULL << pos);
+        opponent &= ~flips;
+    }
+
+    m_sideToMove = -m_sideToMove;
+    return true;
+}
+
+bool OthelloEngine::isGameOver() const {
+    return OthelloGameBoard::generateMoveMask(m_black, m_white) == 0 &&
+           OthelloGameBoard::generateMoveMask(m_white, m_black) == 0;
+}
+
+EngineResult OthelloEngine::search(const SearchLimits &limits) {
+    EngineResult result;
+    m_ctx->reset();
+
+    uint64_t player = m_sideToMove == BLACK ? m_black : m_white;
+    uint64_t opponent = m_sideToMove == BLACK ? m_white : m_black;
+    if(OthelloGameBoard::generateMoveMask(player, opponent) == 0) {
+        return result;
+    }
+
+    if(m_mcts) {
+        // MCTS only knows about time: depth and node limits fall back to the Config move time.
+        SearchContext::Clock::time_point deadline = SearchContext::Clock::time_point::max();
+        if(limits.moveTimeMs > 0) {
+            deadline = SearchContext::now() + std::chrono::milliseconds(limits.moveTimeMs);
+        } else if(!limits.infinite) {
+            deadline = SearchContext::now() + std::chrono::milliseconds((int64_t) (m_cfg.getMoveTime() * 1000));
+        }
+
+        result.move = m_mcts->search(player, opponent, deadline, *m_ctx);
+
+        const MctsStats &stats = m_mcts->getLastStats();
+        result.score = (int) (stats.winRate * 100 + 0.5);
+        result.depth = stats.maxDepth;
+        result.nodes = stats.playouts;
+        result.timeMs = stats.timeMs;
+        return result;
+    }
+
+    BitBoard playerBoard(m_sideToMove), opponentBoard(-m_sideToMove);
+    playerBoard.setBits(player);
+    opponentBoard.setBits(opponent);
+
+    // Built for the side to move, so its scores are already from that side's point of view.
+    OthelloGameBoard board(m_cfg, m_sideToMove, playerBoard, opponentBoard);
+    Move move = board.selectMove(m_sideToMove, limits, *m_ctx);
+    const SearchInfo &info = board.getLastSearchInfo();
+
+    result.move = move.isPass() ? -1 : move.getPos();
+    result.score = info.score;
+    result.depth = info.depth;
+    result.nodes = info.nodes;
+    result.timeMs = info.timeMs;
+    result.lines = m_ctx->getLines();
+
+    const int *pv = m_ctx->getSeedPv();
+    result.pvLength = m_ctx->getSeedLength();
+    for(int i = 0; i < result.pvLength; i++) {
+        result.pv[i] = pv[i];
+    }
+    // No iteration completed: the move came from move ordering alone.
+    if(result.pvLength == 0 || result.pv[0] != result.move) {
+        result.pv[0] = result.move;
+        result.pvLength = 1;
+    }
+
+    return result;
+}
+
+void OthelloEngine::stop() {
+    m_ctx->stop();
+}
+
+void OthelloEngine::setStopCallback(SearchContext::StopCallback callback, void *user) {
+    m_ctx->setStopCallback(callback, user);
+}
+
+void OthelloEngine::setIterationCallback(SearchContext::IterationCallback callback, void *user) {
+    m_ctx->setIterationCallback(callback, user);
+}
+
+int OthelloEngine::evaluate() const {
+    BitBoard playerBoard(m_sideToMove), opponentBoard(-m_sideToMove);
+    playerBoard.setBits(m_sideToMove == BLACK ? m_black : m_white);
+    opponentBoard.setBits(m_sideToMove == BLACK ? m_white : m_black);
+
+    OthelloGameBoard board(m_cfg, m_sideToMove, playerBoard, opponentBoard);
+    return board.evaluate();
+}
+
+bool OthelloEngine::loadHash(const std::string &path, bool readOnly) {
+    return m_tt->load(path, m_cfg.getSearchParams(), readOnly);
+}
+
+bool OthelloEngine::saveHash(const std::string &path) const {
+    return m_tt->save(path, m_cfg.getSearchParams());
+}
+
+void OthelloEngine::clearHash() {
+    m_tt->clear();
+}
+
+bool OthelloEngine::loadNetwork(const std::string &path) {
+    return Nnue::load(path);
+}
+
+void OthelloEngine::setLogSink(LogSink sink, void *user, LogLevel level) {
+    g_sinkChosen.store(true);
+    Logger::setSink(sink != nullptr ? sink : Logger::discard, user);
+    Logger::setLevel(sink != nullptr ? level : LogLevel::Off);
+}
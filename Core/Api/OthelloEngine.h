@@ -0,0 +1,171 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_OTHELLOENGINE_H
+#define OTHELLOPROJECT_CPP_OTHELLOENGINE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../Config.h"
+#include "../Logger.h"
+#include "../Search/SearchContext.h"
+#include "../Search/SearchLimits.h"
+#include "../Search/TranspositionTable.h"
+
+class Mcts;
+
+/**
+ * Settings fixed for the lifetime of an OthelloEngine.
+ */
+struct EngineOptions {
+    EngineType engine = EngineType::AlphaBeta;
+    /**
+     * Search threads for engines that support it, 0 for one per core.
+     */
+    int threads = 0;
+    /**
+     * Game time in seconds, used for the move time when a search has no limits.
+     */
+    int gameTime = 120;
+    /**
+     * Drop engine log output unless setLogSink has been called. Front ends that own stdout turn this off.
+     */
+    bool quiet = true;
+    /**
+     * Transposition table size in megabytes.
+     */
+    int hashMb = TT_DEFAULT_MB;
+    SearchParams searchParams;
+};
+
+/**
+ * Outcome of OthelloEngine::search.
+ */
+struct EngineResult {
+    /**
+     * Board position of the chosen move, or -1 for a pass.
+     */
+    int move = -1;
+    /**
+     * Score from the side to move's point of view (win rate in percent for MCTS).
+     */
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    uint64_t timeMs = 0;
+    /**
+     * Principal variation of the last completed iteration, starting with move. Empty for MCTS.
+     */
+    int pv[MAX_SEARCH_PLY] = {};
+    int pvLength = 0;
+    /**
+     * The best SearchLimits::multiPv moves with exact scores and their lines, best first. Empty for MCTS.
+     */
+    std::vector<SearchLine> lines;
+};
+
+/**
+ * In-process engine API for embedding: position setup, move generation, search and evaluation.
+ *
+ * Bitboards use the engine's layout (H8 = bit 0, A1 = bit 63) and colors are BLACK / WHITE from
+ * Color.h. Nothing is written to stdout: engine log output goes to the sink installed with
+ * setLogSink, and is dropped if there is none.
+ *
+ * An engine is used from one thread at a time, except for stop(), which may be called from any thread.
+ */
+class OthelloEngine {
+public:
+    explicit OthelloEngine(const EngineOptions &options = EngineOptions());
+    ~OthelloEngine();
+
+    OthelloEngine(const OthelloEngine &) = delete;
+    OthelloEngine &operator=(const OthelloEngine &) = delete;
+
+    /**
+     * Sets up the starting position, black to move.
+     */
+    void newGame();
+    /**
+     * @param sideToMove BLACK or WHITE.
+     * @return False (leaving the position unchanged) if the discs overlap or the color is invalid.
+     */
+    bool setPosition(uint64_t black, uint64_t white, int sideToMove);
+    uint64_t getBlack() const;
+    uint64_t getWhite() const;
+    int getSideToMove() const;
+
+    /**
+     * @return Mask of the legal moves for the side to move.
+     */
+    uint64_t getLegalMoves() const;
+    /**
+     * Plays a move for the side to move.
+     * @param pos Board position, or -1 to pass. Passing is only legal without any legal move.
+     * @return False (leaving the position unchanged) if the move is illegal.
+     */
+    bool play(int pos);
+    /**
+     * @return True if neither side can move.
+     */
+    bool isGameOver() const;
+
+    /**
+     * Searches the current position. Blocks until a limit is reached or stop() is called.
+     */
+    EngineResult search(const SearchLimits &limits);
+    /**
+     * Aborts a search in progress. Safe to call from any thread.
+     */
+    void stop();
+    /**
+     * Installs a callback polled during search; returning true stops it. It may be called from a
+     * search thread. Pass nullptr to remove.
+     */
+    void setStopCallback(SearchContext::StopCallback callback, void *user);
+    /**
+     * Installs a callback that receives every completed iteration of an alpha-beta search (every line
+     * of it in multi-PV searches), on the thread running the search. Pass nullptr to remove.
+     */
+    void setIterationCallback(SearchContext::IterationCallback callback, void *user);
+    /**
+     * @return Static evaluation of the current position from the side to move's point of view.
+     */
+    int evaluate() const;
+
+    /**
+     * Replaces the transposition table with a snapshot saved by saveHash, see TranspositionTable::load.
+     */
+    bool loadHash(const std::string &path, bool readOnly = false);
+    bool saveHash(const std::string &path) const;
+    /**
+     * Forgets all search results. The table is kept across newGame() otherwise.
+     */
+    void clearHash();
+
+    /**
+     * Loads a network for the neural evaluator. Affects every engine in the process.
+     */
+    static bool loadNetwork(const std::string &path);
+    /**
+     * Routes engine log output, which is otherwise dropped, to sink.
+     * @param level Most verbose level to pass on.
+     */
+    static void setLogSink(LogSink sink, void *user, LogLevel level = LogLevel::Info);
+
+private:
+    Config m_cfg;
+    uint64_t m_black;
+    uint64_t m_white;
+    int m_sideToMove;
+
+    std::unique_ptr<SearchContext> m_ctx;
+    std::unique_ptr<TranspositionTable> m_tt;
+    std::unique_ptr<Mcts> m_mcts;
+    std::unique_ptr<DfpnSolver> m_solver;
+};
+
+#endif //OTHELLOPROJECT_CPP_OTHELLOENGINE_H
@@ -0,0 +1,109 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "Bits.h"
+
+namespace {
+
+Bits::Features detectFeatures() {
+    Bits::Features features;
+#ifdef BITS_HAS_X86
+    __builtin_cpu_init();
+    features.popcnt = __builtin_cpu_supports("popcnt");
+#endif
+    return features;
+}
+
+uint64_t nextRandom(uint64_t &state) {
+    // splitmix64
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+}
+
+int Bits::popcountPortable(uint64_t b) {
+    b = b - ((b >> 1) & 0x5555555555555555ULL);
+    b = (b & 0x3333333333333333ULL) + ((b >> 2) & 0x3333333333333333ULL);
+    b = (b + (b >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int) ((b * 0x0101010101010101ULL) >> 56);
+}
+
+int Bits::lowestPortable(uint64_t b) {
+    int pos = 0;
+    while((b & 1) == 0) {
+        b >>= 1;
+        pos++;
+    }
+    return pos;
+}
+
+const Bits::Features &Bits::getFeatures() {
+    static const Features features = detectFeatures();
+    return features;
+}
+
+std::string Bits::describe() {
+    const Features &features = getFeatures();
+    std::string s;
+
+#if defined(__POPCNT__)
+    s += "popcount: popcnt (compile time)";
+#elif defined(BITS_HAS_DISPATCH)
+    s += features.popcnt ? "popcount: popcnt (runtime dispatch)" : "popcount: library (runtime dispatch)";
+#else
+    s += "popcount: library";
+#endif
+#if defined(__BMI__)
+    s += ", lowest: tzcnt";
+#else
+    s += ", lowest: bsf";
+#endif
+
+    s += std::string(" (host: popcnt ") + (features.popcnt ? "yes" : "no") + ")";
+    return s;
+}
+
+BITS_DISPATCH bool Bits::verify(int samples) {
+    uint64_t rng = 0x243F6A8885A308D3ULL;
+    bool ok = true;
+
+    for(int i = -4; i < samples; i++) {
+        uint64_t b;
+        if(i < 0) {
+            // Edge cases: empty, full, single top bit, alternating.
+            const uint64_t edges[4] = {0, ~0ULL, 1ULL << 63, 0xAAAAAAAAAAAAAAAAULL};
+            b = edges[i + 4];
+        } else {
+            // Mix dense and sparse values so both short and long loops are covered.
+            b = nextRandom(rng);
+            if(i & 1) {
+                b &= nextRandom(rng);
+            }
+            if(i & 2) {
+                b &= nextRandom(rng);
+            }
+        }
+
+        int count = popcountPortable(b);
+        ok &= popcount(b) == count;
+
+        int visited = 0;
+        uint64_t rebuilt = 0;
+        forEach(b, [&](int pos) {
+            visited++;
+            rebuilt |= 1ULL << pos;
+        });
+        ok &= visited == count && rebuilt == b;
+
+        if(b != 0) {
+            int low = lowestPortable(b);
+            ok &= lowest(b) == low && clearLowest(b) == (b ^ (1ULL << low));
+        }
+    }
+
+    return ok;
+}
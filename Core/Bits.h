@@ -0,0 +1,97 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_BITS_H
+#define OTHELLOPROJECT_CPP_BITS_H
+
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BITS_HAS_X86 1
+#endif
+
+// Marks a hot function that uses the helpers below to be compiled twice, with and without popcnt,
+// and picked by the loader for the host. Calls between marked functions in one file go straight to
+// the matching copy, so a search pays for the choice once, at its entry. Nothing to do when the
+// build already targets popcnt (-mpopcnt or a matching -march).
+#if defined(BITS_HAS_X86) && !defined(__POPCNT__) && defined(__ELF__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define BITS_HAS_DISPATCH 1
+#endif
+#endif
+#ifdef BITS_HAS_DISPATCH
+#define BITS_DISPATCH __attribute__((target_clones("popcnt", "default")))
+#else
+#define BITS_DISPATCH
+#endif
+
+/**
+ * Bit manipulation helpers for bitboards.
+ *
+ * The helpers are compiler builtins, so they use whatever instructions the calling function is
+ * compiled for: everywhere with -mpopcnt / -march, otherwise in the popcnt copy of BITS_DISPATCH
+ * functions. Elsewhere popcount is a library call, which is fine outside the search. verify()
+ * checks the helpers, as a BITS_DISPATCH function, against the portable versions.
+ *
+ * Set bits should be visited with forEach or a lowest / clearLowest loop, never by testing all 64
+ * positions.
+ */
+class Bits {
+public:
+    /**
+     * CPU features found on the host at runtime.
+     */
+    struct Features {
+        bool popcnt = false;
+    };
+
+    /**
+     * @return Number of set bits.
+     */
+    static inline int popcount(uint64_t b) {
+        return __builtin_popcountll(b);
+    }
+
+    /**
+     * @return Index of the lowest set bit. b must not be 0.
+     */
+    static inline int lowest(uint64_t b) {
+        return __builtin_ctzll(b);
+    }
+
+    /**
+     * @return b with its lowest set bit cleared (BLSR with BMI1).
+     */
+    static inline uint64_t clearLowest(uint64_t b) {
+        return b & (b - 1);
+    }
+
+    /**
+     * Calls f(pos) for every set bit, lowest first.
+     */
+    template<typename F>
+    static inline void forEach(uint64_t b, F f) {
+        for(; b != 0; b = clearLowest(b)) {
+            f(lowest(b));
+        }
+    }
+
+    static int popcountPortable(uint64_t b);
+    static int lowestPortable(uint64_t b);
+
+    static const Features &getFeatures();
+    /**
+     * @return Which implementation each helper uses in this binary on this host, for logging.
+     */
+    static std::string describe();
+    /**
+     * Compares the helpers, built the way the search uses them on this host, against the portable
+     * versions on edge cases and the given number of random inputs.
+     * @return True if all results agree.
+     */
+    static bool verify(int samples = 100000);
+};
+
+#endif //OTHELLOPROJECT_CPP_BITS_H
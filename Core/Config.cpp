@@ -4,12 +4,52 @@
 
 #include "Config.h"
 
-Config::Config(bool interactive, int game_time) : m_move_time(game_time / 30.0), m_interactive(interactive) {}
+#include "Search/TranspositionTable.h"
+
+Config::Config(bool interactive, int game_time) : m_game_time(game_time), m_interactive(interactive),
+                                                  m_engine(EngineType::AlphaBeta), m_threads(0),
+                                                  m_hashMb(TT_DEFAULT_MB) {}
 
 double Config::getMoveTime() const {
-    return m_move_time;
+    return (double) m_game_time / m_searchParams.moveTimeDivisor;
+}
+
+int Config::getGameTime() const {
+    return m_game_time;
 }
 
 bool Config::isInteractive() const {
     return m_interactive;
-}
\ No newline at end of file
+}
+
+EngineType Config::getEngine() const {
+    return m_engine;
+}
+
+void Config::setEngine(EngineType engine) {
+    m_engine = engine;
+}
+
+int Config::getThreads() const {
+    return m_threads;
+}
+
+void Config::setThreads(int threads) {
+    m_threads = threads;
+}
+
+int Config::getHashMb() const {
+    return m_hashMb;
+}
+
+void Config::setHashMb(int megabytes) {
+    m_hashMb = megabytes;
+}
+
+const SearchParams &Config::getSearchParams() const {
+    return m_searchParams;
+}
+
+void Config::setSearchParams(const SearchParams &params) {
+    m_searchParams = params;
+}
@@ -5,16 +5,54 @@
 #ifndef OTHELLOPROJECT_CPP_CONFIG_H
 #define OTHELLOPROJECT_CPP_CONFIG_H
 
+#include "Search/SearchParams.h"
+
+/**
+ * Which search selects the agent's moves.
+ */
+enum class EngineType {
+    AlphaBeta,
+    Mcts
+};
 
 class Config {
 public:
     Config(bool interactive, int game_time);
 
     bool isInteractive() const;
+    /**
+     * @return Seconds for a move without other limits: the game time over SearchParams::moveTimeDivisor.
+     */
     double getMoveTime() const;
+    /**
+     * @return Seconds for the whole game, per side.
+     */
+    int getGameTime() const;
+
+    EngineType getEngine() const;
+    void setEngine(EngineType engine);
+    /**
+     * @return Number of search threads for engines that support it. 0 means one per core.
+     */
+    int getThreads() const;
+    void setThreads(int threads);
+    /**
+     * @return Transposition table size in megabytes.
+     */
+    int getHashMb() const;
+    void setHashMb(int megabytes);
+    /**
+     * @return Parameters for alpha-beta searches run with this configuration, see SearchParams.
+     */
+    const SearchParams &getSearchParams() const;
+    void setSearchParams(const SearchParams &params);
 private:
     bool m_interactive;
-    double m_move_time;
+    int m_game_time;
+    EngineType m_engine;
+    int m_threads;
+    int m_hashMb;
+    SearchParams m_searchParams;
 };
 
 
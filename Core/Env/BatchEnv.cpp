@@ -0,0 +1,240 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "BatchEnv.h"
+
+#include <cstdlib>
+
+#include "../Bits.h"
+
+#ifdef BITS_HAS_X86
+#include <immintrin.h>
+#endif
+
+#define BLACK_START 0x0000000810000000ULL
+#define WHITE_START 0x0000001008000000ULL
+#define DIRECTION_COUNT 8
+// Longest run of opponent discs that can be flipped in one direction.
+#define MAX_RUN 6
+
+namespace {
+
+// Same direction encoding as OthelloGameBoard: positive shifts go left, negative right.
+const int DIR_SHIFTS[DIRECTION_COUNT] = {8, 9, 1, -7, -8, -9, -1, 7};
+const uint64_t DIR_MASKS[DIRECTION_COUNT] = {
+        0xFFFFFFFFFFFFFF00ULL, 0xFEFEFEFEFEFEFE00ULL, 0xFEFEFEFEFEFEFEFEULL, 0x00FEFEFEFEFEFEFEULL,
+        0x00FFFFFFFFFFFFFFULL, 0x007F7F7F7F7F7F7FULL, 0x7F7F7F7F7F7F7F7FULL, 0x7F7F7F7F7F7F7F00ULL
+};
+
+inline uint64_t shift(uint64_t b, int dir) {
+    int s = DIR_SHIFTS[dir];
+    return (s > 0 ? b << s : b >> -s) & DIR_MASKS[dir];
+}
+
+uint64_t movesScalar(uint64_t player, uint64_t opponent) {
+    uint64_t empty = ~(player | opponent);
+    uint64_t moves = 0;
+
+    for(int dir = 0; dir < DIRECTION_COUNT; dir++) {
+        uint64_t run = shift(player, dir) & opponent;
+        for(int i = 1; i < MAX_RUN; i++) {
+            run |= shift(run, dir) & opponent;
+        }
+        moves |= shift(run, dir) & empty;
+    }
+
+    return moves;
+}
+
+uint64_t flipsScalar(uint64_t player, uint64_t opponent, uint64_t moveBit) {
+    uint64_t flips = 0;
+
+    for(int dir = 0; dir < DIRECTION_COUNT; dir++) {
+        uint64_t run = shift(moveBit, dir) & opponent;
+        for(int i = 1; i < MAX_RUN; i++) {
+            run |= shift(run, dir) & opponent;
+        }
+        if(shift(run, dir) & player) {
+            flips |= run;
+        }
+    }
+
+    return flips;
+}
+
+inline uint64_t moveBit(int8_t move) {
+    return move == BATCH_PASS ? 0 : 1ULL << move;
+}
+
+inline void finishGame(uint64_t player, uint64_t opponent, uint64_t legal, uint64_t opponentLegal,
+                       uint8_t &done, int8_t &reward) {
+    done = legal == 0 && opponentLegal == 0;
+    reward = 0;
+    if(done) {
+        int diff = Bits::popcount(player) - Bits::popcount(opponent);
+        reward = (int8_t) ((diff > 0) - (diff < 0));
+    }
+}
+
+void legalScalar(GameBatch batch, uint64_t *legal, size_t from) {
+    for(size_t i = from; i < batch.count; i++) {
+        legal[i] = movesScalar(batch.player[i], batch.opponent[i]);
+    }
+}
+
+void applyScalar(GameBatch batch, const int8_t *moves, size_t from) {
+    for(size_t i = from; i < batch.count; i++) {
+        uint64_t bit = moveBit(moves[i]);
+        uint64_t flips = flipsScalar(batch.player[i], batch.opponent[i], bit);
+        uint64_t mover = batch.player[i] | flips | bit;
+
+        batch.player[i] = batch.opponent[i] & ~flips;
+        batch.opponent[i] = mover;
+    }
+}
+
+void terminalScalar(GameBatch batch, const uint64_t *legal, uint8_t *done, int8_t *reward, size_t from) {
+    for(size_t i = from; i < batch.count; i++) {
+        // The other side's moves only matter once the side to move is stuck.
+        uint64_t opponentLegal = legal[i] != 0 ? 1 : movesScalar(batch.opponent[i], batch.player[i]);
+        finishGame(batch.player[i], batch.opponent[i], legal[i], opponentLegal, done[i], reward[i]);
+    }
+}
+
+#ifdef BITS_HAS_X86
+// Four games per vector, one per 64-bit lane.
+
+__attribute__((target("avx2")))
+inline __m256i shiftAvx2(__m256i b, int dir) {
+    int s = DIR_SHIFTS[dir];
+    __m128i count = _mm_cvtsi32_si128(std::abs(s));
+    __m256i shifted = s > 0 ? _mm256_sll_epi64(b, count) : _mm256_srl_epi64(b, count);
+    return _mm256_and_si256(shifted, _mm256_set1_epi64x((long long) DIR_MASKS[dir]));
+}
+
+__attribute__((target("avx2")))
+inline __m256i movesAvx2(__m256i player, __m256i opponent) {
+    __m256i empty = _mm256_xor_si256(_mm256_or_si256(player, opponent), _mm256_set1_epi64x(-1));
+    __m256i moves = _mm256_setzero_si256();
+
+    for(int dir = 0; dir < DIRECTION_COUNT; dir++) {
+        __m256i run = _mm256_and_si256(shiftAvx2(player, dir), opponent);
+        for(int i = 1; i < MAX_RUN; i++) {
+            run = _mm256_or_si256(run, _mm256_and_si256(shiftAvx2(run, dir), opponent));
+        }
+        moves = _mm256_or_si256(moves, _mm256_and_si256(shiftAvx2(run, dir), empty));
+    }
+
+    return moves;
+}
+
+__attribute__((target("avx2")))
+void legalAvx2(GameBatch batch, uint64_t *legal) {
+    size_t i = 0;
+    for(; i + 4 <= batch.count; i += 4) {
+        __m256i player = _mm256_loadu_si256((const __m256i *) (batch.player + i));
+        __m256i opponent = _mm256_loadu_si256((const __m256i *) (batch.opponent + i));
+        _mm256_storeu_si256((__m256i *) (legal + i), movesAvx2(player, opponent));
+    }
+    legalScalar(batch, legal, i);
+}
+
+__attribute__((target("avx2")))
+void applyAvx2(GameBatch batch, const int8_t *moves) {
+    size_t i = 0;
+    for(; i + 4 <= batch.count; i += 4) {
+        __m256i player = _mm256_loadu_si256((const __m256i *) (batch.player + i));
+        __m256i opponent = _mm256_loadu_si256((const __m256i *) (batch.opponent + i));
+        __m256i bit = _mm256_set_epi64x((long long) moveBit(moves[i + 3]), (long long) moveBit(moves[i + 2]),
+                                        (long long) moveBit(moves[i + 1]), (long long) moveBit(moves[i]));
+        __m256i zero = _mm256_setzero_si256();
+        __m256i flips = zero;
+
+        for(int dir = 0; dir < DIRECTION_COUNT; dir++) {
+            __m256i run = _mm256_and_si256(shiftAvx2(bit, dir), opponent);
+            for(int k = 1; k < MAX_RUN; k++) {
+                run = _mm256_or_si256(run, _mm256_and_si256(shiftAvx2(run, dir), opponent));
+            }
+            // Keep the run only in lanes where it ends on one of the mover's discs.
+            __m256i unbounded = _mm256_cmpeq_epi64(_mm256_and_si256(shiftAvx2(run, dir), player), zero);
+            flips = _mm256_or_si256(flips, _mm256_andnot_si256(unbounded, run));
+        }
+
+        __m256i mover = _mm256_or_si256(_mm256_or_si256(player, flips), bit);
+        _mm256_storeu_si256((__m256i *) (batch.player + i), _mm256_andnot_si256(flips, opponent));
+        _mm256_storeu_si256((__m256i *) (batch.opponent + i), mover);
+    }
+    applyScalar(batch, moves, i);
+}
+
+__attribute__((target("avx2")))
+void terminalAvx2(GameBatch batch, const uint64_t *legal, uint8_t *done, int8_t *reward) {
+    size_t i = 0;
+    for(; i + 4 <= batch.count; i += 4) {
+        __m256i player = _mm256_loadu_si256((const __m256i *) (batch.player + i));
+        __m256i opponent = _mm256_loadu_si256((const __m256i *) (batch.opponent + i));
+
+        alignas(32) uint64_t opponentLegal[4];
+        _mm256_store_si256((__m256i *) opponentLegal, movesAvx2(opponent, player));
+
+        for(int k = 0; k < 4; k++) {
+            finishGame(batch.player[i + k], batch.opponent[i + k], legal[i + k], opponentLegal[k],
+                       done[i + k], reward[i + k]);
+        }
+    }
+    terminalScalar(batch, legal, done, reward, i);
+}
+#endif
+
+struct Kernels {
+    void (*legal)(GameBatch, uint64_t *);
+    void (*apply)(GameBatch, const int8_t *);
+    void (*terminal)(GameBatch, const uint64_t *, uint8_t *, int8_t *);
+    const char *name;
+};
+
+const Kernels &kernels() {
+    static const Kernels selected = [] {
+#ifdef BITS_HAS_X86
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2")) {
+            return Kernels{legalAvx2, applyAvx2, terminalAvx2, "avx2"};
+        }
+#endif
+        return Kernels{
+                [](GameBatch batch, uint64_t *legal) { legalScalar(batch, legal, 0); },
+                [](GameBatch batch, const int8_t *moves) { applyScalar(batch, moves, 0); },
+                [](GameBatch batch, const uint64_t *legal, uint8_t *done, int8_t *reward) {
+                    terminalScalar(batch, legal, done, reward, 0);
+                },
+                "scalar"
+        };
+    }();
+    return selected;
+}
+
+}
+
+void BatchEnv::reset(GameBatch batch) {
+    for(size_t i = 0; i < batch.count; i++) {
+        batch.player[i] = BLACK_START;
+        batch.opponent[i] = WHITE_START;
+    }
+}
+
+void BatchEnv::legalMoves(GameBatch batch, uint64_t *legal) {
+    kernels().legal(batch, legal);
+}
+
+void BatchEnv::applyMoves(GameBatch batch, const int8_t *moves) {
+    kernels().apply(batch, moves);
+}
+
+void BatchEnv::terminal(GameBatch batch, const uint64_t *legal, uint8_t *done, int8_t *reward) {
+    kernels().terminal(batch, legal, done, reward);
+}
+
+const char *BatchEnv::getKernelName() {
+    return kernels().name;
+}
@@ -0,0 +1,63 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_BATCHENV_H
+#define OTHELLOPROJECT_CPP_BATCHENV_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Move value for a pass in BatchEnv::applyMoves.
+#define BATCH_PASS (-1)
+
+/**
+ * N games stored as structure-of-arrays bitboards in memory owned by the caller.
+ * Each game is always stored from the point of view of the side to move: player[i] holds the
+ * discs of the side to move in game i, opponent[i] those of the other side.
+ */
+struct GameBatch {
+    uint64_t *player;
+    uint64_t *opponent;
+    size_t count;
+};
+
+/**
+ * Steps many games at once for rollout and reinforcement-learning workloads.
+ *
+ * Every call works on all games of a GameBatch in place, without copying or allocating. The
+ * kernels are vectorized across games: with AVX2, four games are processed per instruction, each
+ * direction of the move generator and flip search running for all four in lockstep without
+ * per-game branches. The kernel is picked at runtime and the scalar version is used elsewhere.
+ */
+class BatchEnv {
+public:
+    /**
+     * Sets every game to the starting position, black to move.
+     */
+    static void reset(GameBatch batch);
+    /**
+     * Computes the legal move mask of the side to move in every game.
+     * @param legal Output, one mask per game.
+     */
+    static void legalMoves(GameBatch batch, uint64_t *legal);
+    /**
+     * Plays one move in every game, then swaps the sides so that player[] is the new side to move.
+     * @param moves Board position per game, or BATCH_PASS. Moves must be legal; this is not checked.
+     */
+    static void applyMoves(GameBatch batch, const int8_t *moves);
+    /**
+     * Detects finished games and scores them.
+     * @param legal Legal move masks from legalMoves for the current positions.
+     * @param done Output, 1 if neither side can move.
+     * @param reward Output, for finished games 1, 0 or -1 as the side to move has won, drawn or lost.
+     * 0 for games still in progress.
+     */
+    static void terminal(GameBatch batch, const uint64_t *legal, uint8_t *done, int8_t *reward);
+    /**
+     * @return Name of the kernel in use, for logging.
+     */
+    static const char *getKernelName();
+};
+
+#endif //OTHELLOPROJECT_CPP_BATCHENV_H
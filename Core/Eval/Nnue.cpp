@@ -0,0 +1,297 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "Nnue.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NNUE_HAS_X86 1
+#endif
+
+#include "../Bits.h"
+#include "../OthelloGame/OthelloGameBoard.h"
+#include "../Records/ByteIO.h"
+
+namespace {
+
+struct Network {
+    alignas(32) int16_t bias1[NNUE_HIDDEN];
+    alignas(32) int16_t weights1[NNUE_INPUTS][NNUE_HIDDEN];
+    // weights1[sq] - weights1[64 + sq]: applied when a disc on sq changes from the opponent to the player.
+    alignas(32) int16_t flipDelta[64][NNUE_HIDDEN];
+    alignas(32) int8_t weights2[NNUE_HIDDEN];
+    int32_t bias2;
+    int shift;
+};
+
+Network g_net;
+bool g_loaded = false;
+uint64_t g_signature = 0;
+
+int32_t forwardScalar(const int16_t *acc) {
+    int32_t sum = 0;
+    for(int i = 0; i < NNUE_HIDDEN; i++) {
+        int16_t v = acc[i];
+        v = v < 0 ? 0 : (v > 127 ? 127 : v);
+        sum += v * g_net.weights2[i];
+    }
+    return sum;
+}
+
+#ifdef NNUE_HAS_X86
+__attribute__((target("avx2")))
+int32_t forwardAvx2(const int16_t *acc) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i limit = _mm256_set1_epi16(127);
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum = _mm256_setzero_si256();
+
+    for(int i = 0; i < NNUE_HIDDEN; i += 32) {
+        __m256i a = _mm256_load_si256((const __m256i *) (acc + i));
+        __m256i b = _mm256_load_si256((const __m256i *) (acc + i + 16));
+        a = _mm256_min_epi16(_mm256_max_epi16(a, zero), limit);
+        b = _mm256_min_epi16(_mm256_max_epi16(b, zero), limit);
+
+        // packs works per 128-bit lane; the permute restores the original order.
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(a, b), 0xD8);
+        __m256i weights = _mm256_load_si256((const __m256i *) (g_net.weights2 + i));
+
+        // u8 * i8 pairs fit in int16 since activations are at most 127.
+        __m256i products = _mm256_maddubs_epi16(packed, weights);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+    }
+
+    __m128i lo = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    lo = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, 0x4E));
+    lo = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, 0xB1));
+    return _mm_cvtsi128_si32(lo);
+}
+#endif
+
+int32_t (*g_forward)(const int16_t *) = forwardScalar;
+const char *g_kernelName = "scalar";
+
+inline void addColumn(int16_t *acc, const int16_t *column) {
+    for(int i = 0; i < NNUE_HIDDEN; i++) {
+        acc[i] += column[i];
+    }
+}
+
+inline void subColumn(int16_t *acc, const int16_t *column) {
+    for(int i = 0; i < NNUE_HIDDEN; i++) {
+        acc[i] -= column[i];
+    }
+}
+
+}
+
+bool Nnue::load(const std::string &path) {
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if(file == nullptr) {
+        return false;
+    }
+
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t read;
+    while((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + read);
+    }
+    std::fclose(file);
+
+    const size_t expected = 12 + 2 * NNUE_HIDDEN + 2 * NNUE_INPUTS * NNUE_HIDDEN + NNUE_HIDDEN + 4;
+    if(data.size() != expected || memcmp(data.data(), "ONN1", 4) != 0 ||
+       ByteIO::getU32(data.data() + 4) != NNUE_HIDDEN || ByteIO::getU32(data.data() + 8) > 30) {
+        return false;
+    }
+
+    Network net;
+    const uint8_t *p = data.data() + 8;
+    net.shift = (int) ByteIO::getU32(p);
+    p += 4;
+
+    for(int i = 0; i < NNUE_HIDDEN; i++, p += 2) {
+        net.bias1[i] = (int16_t) ByteIO::getU16(p);
+    }
+    for(int f = 0; f < NNUE_INPUTS; f++) {
+        for(int i = 0; i < NNUE_HIDDEN; i++, p += 2) {
+            net.weights1[f][i] = (int16_t) ByteIO::getU16(p);
+        }
+    }
+    for(int i = 0; i < NNUE_HIDDEN; i++) {
+        net.weights2[i] = (int8_t) *p++;
+    }
+    net.bias2 = (int32_t) ByteIO::getU32(p);
+
+    for(int sq = 0; sq < 64; sq++) {
+        for(int i = 0; i < NNUE_HIDDEN; i++) {
+            net.flipDelta[sq][i] = (int16_t) (net.weights1[sq][i] - net.weights1[64 + sq][i]);
+        }
+    }
+
+    uint64_t signature = 0xCBF29CE484222325ULL;
+    for(uint8_t byte : data) {
+        signature = (signature ^ byte) * 0x100000001B3ULL;
+    }
+
+    g_net = net;
+    g_loaded = true;
+    g_signature = signature;
+
+#ifdef NNUE_HAS_X86
+    if(__builtin_cpu_supports("avx2")) {
+        g_forward = forwardAvx2;
+        g_kernelName = "avx2";
+    }
+#endif
+
+    return true;
+}
+
+bool Nnue::isLoaded() {
+    return g_loaded;
+}
+
+const char *Nnue::getKernelName() {
+    return g_kernelName;
+}
+
+uint64_t Nnue::getSignature() {
+    return g_signature;
+}
+
+void Nnue::refresh(NnueAccumulator &acc, uint64_t playerDisks, uint64_t oppDisks) {
+    memcpy(acc.values, g_net.bias1, sizeof(acc.values));
+
+    Bits::forEach(playerDisks, [&](int sq) {
+        addColumn(acc.values, g_net.weights1[sq]);
+    });
+    Bits::forEach(oppDisks, [&](int sq) {
+        addColumn(acc.values, g_net.weights1[64 + sq]);
+    });
+}
+
+void Nnue::update(NnueAccumulator &acc, bool byPlayer, int pos, uint64_t flips) {
+    if(byPlayer) {
+        addColumn(acc.values, g_net.weights1[pos]);
+        Bits::forEach(flips, [&](int sq) {
+            addColumn(acc.values, g_net.flipDelta[sq]);
+        });
+    } else {
+        addColumn(acc.values, g_net.weights1[64 + pos]);
+        Bits::forEach(flips, [&](int sq) {
+            subColumn(acc.values, g_net.flipDelta[sq]);
+        });
+    }
+}
+
+int Nnue::evaluate(const NnueAccumulator &acc) {
+    int32_t dot = g_forward(acc.values);
+    // Opt-in, see verify() for the standalone check: the vector kernel must agree exactly with the portable one.
+#ifdef OTHELLO_CHECK_INCREMENTAL
+    assert(dot == forwardScalar(acc.values));
+#endif
+    return (dot + g_net.bias2) >> g_net.shift;
+}
+
+void Nnue::loadRandom(uint64_t seed) {
+    uint64_t state = seed | 1;
+    auto next = [&state](int range) {
+        // xorshift64, then a value in [-range, range]
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return (int) (state % (uint64_t) (2 * range + 1)) - range;
+    };
+
+    // Small enough that no accumulator can overflow, large enough to cover both ends of the clipping.
+    Network net;
+    for(int i = 0; i < NNUE_HIDDEN; i++) {
+        net.bias1[i] = (int16_t) next(64);
+        net.weights2[i] = (int8_t) next(127);
+    }
+    for(int f = 0; f < NNUE_INPUTS; f++) {
+        for(int i = 0; i < NNUE_HIDDEN; i++) {
+            net.weights1[f][i] = (int16_t) next(48);
+        }
+    }
+    for(int sq = 0; sq < 64; sq++) {
+        for(int i = 0; i < NNUE_HIDDEN; i++) {
+            net.flipDelta[sq][i] = (int16_t) (net.weights1[sq][i] - net.weights1[64 + sq][i]);
+        }
+    }
+    net.bias2 = next(1000);
+    net.shift = 6;
+
+    g_net = net;
+    g_loaded = true;
+    g_signature = seed;
+    g_forward = forwardScalar;
+    g_kernelName = "scalar";
+#ifdef NNUE_HAS_X86
+    if(__builtin_cpu_supports("avx2")) {
+        g_forward = forwardAvx2;
+        g_kernelName = "avx2";
+    }
+#endif
+}
+
+bool Nnue::verify(int games, uint64_t seed) {
+    uint64_t state = seed | 1;
+    bool ok = true;
+
+    for(int game = 0; game < games; game++) {
+        // Random games, black evaluating. The accumulator is only ever updated incrementally.
+        uint64_t black = 0x0000000810000000ULL, white = 0x0000001008000000ULL;
+        NnueAccumulator acc;
+        refresh(acc, black, white);
+        bool blackToMove = true;
+
+        while(true) {
+            uint64_t &own = blackToMove ? black : white;
+            uint64_t &other = blackToMove ? white : black;
+            uint64_t legal = OthelloGameBoard::generateMoveMask(own, other);
+            if(legal == 0) {
+                if(OthelloGameBoard::generateMoveMask(other, own) == 0) {
+                    break;
+                }
+                blackToMove = !blackToMove;
+                continue;
+            }
+
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            for(int k = (int) (state % (uint64_t) Bits::popcount(legal)); k > 0; k--) {
+                legal = Bits::clearLowest(legal);
+            }
+            int pos = Bits::lowest(legal);
+            uint64_t flips = OthelloGameBoard::getFlips(own, other, pos);
+            own |= flips | (1ULL << pos);
+            other &= ~flips;
+            update(acc, blackToMove, pos, flips);
+            blackToMove = !blackToMove;
+
+            NnueAccumulator fresh;
+            refresh(fresh, black, white);
+            ok &= memcmp(fresh.values, acc.values, sizeof(acc.values)) == 0;
+
+            int32_t scalar = forwardScalar(acc.values);
+            ok &= g_forward(acc.values) == scalar;
+#ifdef NNUE_HAS_X86
+            if(__builtin_cpu_supports("avx2")) {
+                ok &= forwardAvx2(acc.values) == scalar;
+            }
+#endif
+            ok &= evaluate(acc) == (scalar + g_net.bias2) >> g_net.shift;
+        }
+    }
+
+    return ok;
+}
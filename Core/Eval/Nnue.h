@@ -0,0 +1,86 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_NNUE_H
+#define OTHELLOPROJECT_CPP_NNUE_H
+
+#include <cstdint>
+#include <string>
+
+// Inputs: one feature per square for each side (the evaluating player's discs, then the opponent's).
+#define NNUE_INPUTS 128
+// Width of the first layer / accumulator. Must be a multiple of 32.
+#define NNUE_HIDDEN 64
+
+/**
+ * First-layer outputs for one position. Lives inside OthelloGameBoard, so copying a board for a
+ * child node copies its accumulator, and discarding the copy is the unmake.
+ */
+struct NnueAccumulator {
+    alignas(32) int16_t values[NNUE_HIDDEN];
+};
+
+/**
+ * Small quantized neural evaluator, used by OthelloGameBoard::evaluate() instead of the
+ * hand-written heuristic once a network has been loaded.
+ *
+ * Network: 128 binary inputs -> NNUE_HIDDEN int16 (accumulator) -> clipped ReLU [0, 127] -> int8 dot -> score.
+ * The first layer is never evaluated in full during search: each move adds the placed disc's column
+ * and moves every flipped disc from one side's column to the other.
+ *
+ * Weight file layout (little-endian):
+ *   char[4] "ONN1", uint32 hidden (must equal NNUE_HIDDEN), uint32 output shift,
+ *   int16 bias1[hidden], int16 weights1[128][hidden], int8 weights2[hidden], int32 bias2
+ *
+ * The final score is (dot + bias2) >> output shift, in the same units as evaluate().
+ */
+class Nnue {
+public:
+    /**
+     * Loads a network. Also selects the AVX2 or scalar inference path for this CPU.
+     * @return False if the file is missing or malformed; the previous network (if any) stays active.
+     */
+    static bool load(const std::string &path);
+    static bool isLoaded();
+    /**
+     * @return "avx2" or "scalar".
+     */
+    static const char *getKernelName();
+    /**
+     * @return FNV-1a hash of the loaded weight file, identifying the network. 0 if none is loaded.
+     */
+    static uint64_t getSignature();
+
+    /**
+     * Computes the accumulator from scratch.
+     * @param playerDisks Discs of the evaluating player (OthelloGameBoard's player).
+     * @param oppDisks Discs of the other side.
+     */
+    static void refresh(NnueAccumulator &acc, uint64_t playerDisks, uint64_t oppDisks);
+    /**
+     * Incrementally applies a move.
+     * @param byPlayer True if the evaluating player made the move.
+     * @param pos The square the disc was placed on.
+     * @param flips The discs that changed color.
+     */
+    static void update(NnueAccumulator &acc, bool byPlayer, int pos, uint64_t flips);
+    /**
+     * @return The score of the position, from the evaluating player's point of view.
+     */
+    static int evaluate(const NnueAccumulator &acc);
+
+    /**
+     * Replaces the network with random weights, for checks without a weight file.
+     */
+    static void loadRandom(uint64_t seed);
+    /**
+     * Plays random games, keeping an accumulator up to date with update() only, and compares it at
+     * every position with one computed from scratch, and the AVX2 (where the host has it), scalar
+     * and selected inference results with each other. Uses the loaded network.
+     * @return True if all results agree.
+     */
+    static bool verify(int games = 200, uint64_t seed = 1);
+};
+
+#endif //OTHELLOPROJECT_CPP_NNUE_H
@@ -4,8 +4,10 @@
 
 
 #include "InputHandler.h"
+#include "../../Trace.h"
 
 std::string InputHandler::readInput() {
+    TRACE_SCOPE("readInput");
     std::string input;
     std::getline(std::cin, input);
     return input;
@@ -9,16 +9,16 @@
 void OutputHandler::outputDirective(Directive d, const std::string &input) {
     switch(d) {
         case Directive::InitializeBlack:
-            std::cout << "R B" << std::endl;
+            Logger::writeProtocol("R B");
             break;
         case Directive::InitializeWhite:
-            std::cout << "R W" << std::endl;
+            Logger::writeProtocol("R W");
             break;
         case Directive::MoveSelf:
         case Directive::PassBlack:
         case Directive::PassWhite:
         case Directive::Comment:
-            std::cout << input << std::endl;
+            Logger::writeProtocol(input);
             break;
     }
 }
@@ -38,18 +38,15 @@ std::string OutputHandler::getMoveOutput(int c, Move move, bool logComment) {
 
     char colorChar = c == BLACK ? 'B' : 'W';
 
-    // Definitely overkill allocating 255, but we don't want to run into any unforseen errors due to the
-    // string size being too small. So, this is just a safety measure. It's freed at the end anyway.
-    char *str = (char *) malloc(sizeof(char) * 255);
-    sprintf(str, "%c %c %d", colorChar, col, row);
+    // "B a 1": fits the small string buffer, so nothing is allocated.
+    char str[8];
+    snprintf(str, sizeof(str), "%c %c %d", colorChar, col, row);
 
     if(logComment) {
-        Logger::logComment("Converted pos " + std::to_string(pos) + " to " + str);
+        LOG_DEBUG("Converted pos " + std::to_string(pos) + " to " + str);
     }
 
-    std::string ret = std::string(str);
-    free(str);
-    return ret;
+    return std::string(str);
 }
 
 Move OutputHandler::toMove(std::string input) {
@@ -61,11 +58,11 @@ Move OutputHandler::toMove(std::string input) {
 
     if(pos < 0 || pos > 63) {
         // Can happen if we try to convert a standalone letter. e.g. W or B
-        Logger::logComment("Received input '" + input + "'. Returning pos -1!");
+        LOG_DEBUG("Received input '" + input + "'. Returning pos -1!");
         return Move();
     }
 
-    Logger::logComment("Converted " + input + " to pos: " + std::to_string(pos));
+    LOG_DEBUG("Converted " + input + " to pos: " + std::to_string(pos));
 
     return Move(pos, INT32_MIN); // Value of the move is unknown at first.
 }
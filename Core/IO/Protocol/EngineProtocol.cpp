@@ -0,0 +1,191 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "EngineProtocol.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+#include "../Input/InputHandler.h"
+#include "../../Logger.h"
+#include "../../Trace.h"
+#include "../../Utils.h"
+#include "../../OthelloGame/Color.h"
+
+namespace {
+
+EngineOptions protocolOptions(const Config &cfg) {
+    EngineOptions options;
+    options.engine = cfg.getEngine();
+    options.threads = cfg.getThreads();
+    options.hashMb = cfg.getHashMb();
+    options.searchParams = cfg.getSearchParams();
+    options.gameTime = cfg.getGameTime();
+    // Logging stays on stdout as comments, next to the protocol output.
+    options.quiet = false;
+    return options;
+}
+
+std::string formatPv(const int *pv, int pvLength) {
+    std::string s;
+    for(int i = 0; i < pvLength; i++) {
+        s += (i == 0 ? "" : " ") + Utils::posToSquare(pv[i]);
+    }
+    return s;
+}
+
+}
+
+EngineProtocol::EngineProtocol(const Config &cfg) : m_engine(protocolOptions(cfg)), m_stopRequested(false) {
+    m_engine.setStopCallback(shouldStop, this);
+    m_engine.setIterationCallback(onIteration, this);
+}
+
+EngineProtocol::~EngineProtocol() {
+    this->stopSearch();
+}
+
+void EngineProtocol::run() {
+    while(std::cin) {
+        std::string line = InputHandler::readInput();
+        if(!std::cin && line.empty()) {
+            break;
+        }
+        if(!this->handle(line)) {
+            break;
+        }
+    }
+    this->stopSearch();
+}
+
+bool EngineProtocol::handle(const std::string &line) {
+    std::istringstream in(line);
+    std::vector<std::string> args;
+    for(std::string word; in >> word;) {
+        args.push_back(word);
+    }
+
+    if(args.empty()) {
+        return true;
+    }
+
+    const std::string &command = args[0];
+    if(command == "quit") {
+        return false;
+    } else if(command == "isready") {
+        Logger::writeProtocol("readyok");
+    } else if(command == "stop") {
+        this->stopSearch();
+    } else if(command == "position") {
+        this->stopSearch();
+        this->position(args);
+    } else if(command == "go") {
+        this->stopSearch();
+        this->go(args);
+    } else {
+        Logger::writeProtocol("info string unknown command: " + command);
+    }
+
+    return true;
+}
+
+void EngineProtocol::position(const std::vector<std::string> &args) {
+    size_t next = 2;
+
+    if(args.size() >= 2 && args[1] == "startpos") {
+        m_engine.newGame();
+    } else if(args.size() >= 3 && args[1].length() == 64 && (args[2] == "b" || args[2] == "w")) {
+        uint64_t black = 0, white = 0;
+        for(int i = 0; i < 64; i++) {
+            // Text index i is square a1 + i, which is bit 63 - i.
+            char c = args[1][i];
+            if(c == 'B') {
+                black |= 1ULL << (63 - i);
+            } else if(c == 'W') {
+                white |= 1ULL << (63 - i);
+            } else if(c != '-') {
+                Logger::writeProtocol("info string invalid board character: " + std::string(1, c));
+                return;
+            }
+        }
+
+        m_engine.setPosition(black, white, args[2] == "b" ? BLACK : WHITE);
+        next = 3;
+    } else {
+        Logger::writeProtocol("info string invalid position");
+        return;
+    }
+
+    if(next < args.size() && args[next] == "moves") {
+        for(size_t i = next + 1; i < args.size(); i++) {
+            if(!m_engine.play(Utils::squareToPos(args[i]))) {
+                Logger::writeProtocol("info string illegal move: " + args[i]);
+                return;
+            }
+        }
+    }
+}
+
+void EngineProtocol::go(const std::vector<std::string> &args) {
+    SearchLimits limits;
+
+    for(size_t i = 1; i < args.size(); i++) {
+        bool hasValue = i + 1 < args.size();
+        if(args[i] == "infinite") {
+            limits.infinite = true;
+        } else if(args[i] == "depth" && hasValue) {
+            limits.depth = std::max(1, atoi(args[++i].c_str()));
+        } else if(args[i] == "nodes" && hasValue) {
+            limits.nodes = strtoull(args[++i].c_str(), nullptr, 10);
+        } else if(args[i] == "multipv" && hasValue) {
+            limits.multiPv = std::max(1, atoi(args[++i].c_str()));
+        } else if(args[i] == "movetime" && hasValue) {
+            limits.moveTimeMs = std::max(1LL, atoll(args[++i].c_str()));
+        } else {
+            Logger::writeProtocol("info string ignoring go argument: " + args[i]);
+        }
+    }
+
+    m_stopRequested.store(false);
+    m_search = std::thread([this, limits] {
+        TRACE_THREAD_NAME("search");
+        EngineResult result = m_engine.search(limits);
+
+        // An infinite search only reports once it has been told to stop.
+        if(limits.infinite) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_stopped.wait(lock, [this] { return m_stopRequested.load(); });
+        }
+
+        Logger::writeProtocol("bestmove " + Utils::posToSquare(result.move) + " score " + std::to_string(result.score));
+    });
+}
+
+void EngineProtocol::stopSearch() {
+    if(!m_search.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested.store(true);
+    }
+    m_stopped.notify_all();
+    m_engine.stop();
+
+    m_search.join();
+}
+
+bool EngineProtocol::shouldStop(void *user) {
+    // Also catches a stop that arrived before the search had started (and reset the engine's flag).
+    return ((EngineProtocol *) user)->m_stopRequested.load(std::memory_order_relaxed);
+}
+
+void EngineProtocol::onIteration(const SearchInfo &info, const int *pv, int pvLength, void *) {
+    Logger::writeProtocol("info depth " + std::to_string(info.depth) + " multipv " + std::to_string(info.line) +
+                          " score " + std::to_string(info.score) +
+                          " nodes " + std::to_string(info.nodes) + " time " + std::to_string(info.timeMs) +
+                          " pv " + formatPv(pv, pvLength));
+}
@@ -0,0 +1,70 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_ENGINEPROTOCOL_H
+#define OTHELLOPROJECT_CPP_ENGINEPROTOCOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../Config.h"
+#include "../../Api/OthelloEngine.h"
+
+/**
+ * Line-based engine control protocol, an alternative to the referee protocol for schedulers.
+ * Squares are written "d3"; a pass is "pass". Commands:
+ *
+ *   position startpos [moves <m> ...]
+ *   position <64 chars, a1..h1 then a2..h8, B / W / -> <b|w> [moves <m> ...]
+ *   go [depth <n>] [nodes <n>] [movetime <ms>] [infinite] [multipv <k>]
+ *   stop
+ *   isready
+ *   quit
+ *
+ * go searches in the background and streams "info depth <d> multipv <i> score <s> nodes <n> time <ms> pv <m> ..."
+ * for every completed iteration, then answers "bestmove <m> score <s>". With multipv k, each iteration
+ * reports the k best moves with exact scores, best (multipv 1) first. Without limits the move time
+ * comes from the Config, as in referee mode. After "go infinite", bestmove is only sent once
+ * "stop" arrives. Anything else is answered with "info string ...".
+ */
+class EngineProtocol {
+public:
+    explicit EngineProtocol(const Config &cfg);
+    ~EngineProtocol();
+
+    /**
+     * Reads and handles commands from stdin until "quit" or end of input.
+     */
+    void run();
+    /**
+     * Handles a single command line.
+     * @return False once "quit" has been received.
+     */
+    bool handle(const std::string &line);
+
+private:
+    OthelloEngine m_engine;
+
+    std::thread m_search;
+    std::atomic<bool> m_stopRequested;
+    std::mutex m_mutex;
+    std::condition_variable m_stopped;
+
+    void position(const std::vector<std::string> &args);
+    void go(const std::vector<std::string> &args);
+    /**
+     * Stops the running search, if any, and waits for its bestmove to be written.
+     */
+    void stopSearch();
+
+    static bool shouldStop(void *user);
+    static void onIteration(const SearchInfo &info, const int *pv, int pvLength, void *user);
+};
+
+#endif //OTHELLOPROJECT_CPP_ENGINEPROTOCOL_H
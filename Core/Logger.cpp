@@ -4,10 +4,308 @@
 
 #include "Logger.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Trace.h"
+
+// Must be a power of two.
+#define LOG_SLOT_COUNT 4096
+// Longer messages are split across consecutive slots...
+#define LOG_SLOT_TEXT 242
+// ...up to this many, beyond which they are truncated (about 60 KB).
+#define LOG_MAX_PARTS 256
+
+namespace {
+
+enum class RecordKind : uint8_t {
+    Comment,  // "C <text>\n"
+    Raw,      // "<text>", appended to the current line
+    Protocol, // "<text>\n", flushed immediately
+    Barrier   // No output, flushes stdout
+};
+
+std::atomic<LogSink> g_sink(nullptr);
+std::atomic<void *> g_sinkUser(nullptr);
+
+struct Slot {
+    std::atomic<uint64_t> seq;
+    RecordKind kind;
+    // A record split across slots starts in the slot with first set and ends in the one with last set.
+    bool first;
+    bool last;
+    uint16_t length;
+    char text[LOG_SLOT_TEXT];
+};
+
+/**
+ * Bounded multi-producer / single-consumer ring buffer drained by a background thread.
+ * Producers claim all the slots of a record with one CAS on the tail and publish each through its
+ * sequence number. The drain thread sleeps while the queue is empty and is woken by push.
+ */
+class LogQueue {
+public:
+    LogQueue() : m_tail(0), m_head(0), m_written(0), m_stop(false), m_sleeping(false) {
+        for(uint64_t i = 0; i < LOG_SLOT_COUNT; i++) {
+            m_slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+        m_thread = std::thread(&LogQueue::drain, this);
+    }
+
+    ~LogQueue() {
+        uint64_t ticket = this->push(RecordKind::Barrier, nullptr, 0);
+        this->waitFor(ticket);
+
+        m_stop.store(true, std::memory_order_release);
+        this->wake();
+        m_thread.join();
+    }
+
+    /**
+     * @return The ticket of the queued record, usable with waitFor.
+     */
+    uint64_t push(RecordKind kind, const char *text, size_t length) {
+        if(length > (size_t) LOG_SLOT_TEXT * LOG_MAX_PARTS) {
+            length = (size_t) LOG_SLOT_TEXT * LOG_MAX_PARTS;
+        }
+        uint64_t parts = length == 0 ? 1 : (length + LOG_SLOT_TEXT - 1) / LOG_SLOT_TEXT;
+        uint64_t pos = m_tail.load(std::memory_order_relaxed);
+
+        while(true) {
+            // Slots are freed in order, so the record fits once its last slot is free.
+            uint64_t seq = m_slots[pos & (LOG_SLOT_COUNT - 1)].seq.load(std::memory_order_acquire);
+            uint64_t lastSeq = m_slots[(pos + parts - 1) & (LOG_SLOT_COUNT - 1)].seq.load(std::memory_order_acquire);
+            int64_t diff = (int64_t) seq - (int64_t) pos;
+
+            if(diff == 0 && lastSeq == pos + parts - 1) {
+                if(m_tail.compare_exchange_weak(pos, pos + parts, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if(diff <= 0) {
+                // Queue is full; give the drain thread a chance to catch up.
+                this->wake();
+                std::this_thread::yield();
+                pos = m_tail.load(std::memory_order_relaxed);
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        for(uint64_t part = 0; part < parts; part++) {
+            Slot &slot = m_slots[(pos + part) & (LOG_SLOT_COUNT - 1)];
+            size_t partLength = length < LOG_SLOT_TEXT ? length : LOG_SLOT_TEXT;
+            slot.kind = kind;
+            slot.first = part == 0;
+            slot.last = part == parts - 1;
+            slot.length = (uint16_t) partLength;
+            if(partLength > 0) {
+                memcpy(slot.text, text, partLength);
+            }
+            slot.seq.store(pos + part + 1, std::memory_order_release);
+
+            text += partLength;
+            length -= partLength;
+        }
+
+        // Pairs with the fence in drain: either it sees the record, or this sees it going to sleep.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(m_sleeping.load(std::memory_order_relaxed)) {
+            this->wake();
+        }
+
+        return pos + parts - 1;
+    }
+
+    /**
+     * Wakes the drain thread and blocks until the record with the given ticket has been flushed.
+     */
+    void waitFor(uint64_t ticket) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.notify_one();
+        m_done.wait(lock, [&] {
+            return m_written.load(std::memory_order_acquire) > ticket;
+        });
+    }
+
+private:
+    Slot m_slots[LOG_SLOT_COUNT];
+    alignas(64) std::atomic<uint64_t> m_tail;
+    alignas(64) uint64_t m_head;
+    std::atomic<uint64_t> m_written;
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_sleeping;
+    // A split record, collected for the sink, which takes whole records. Only used by the drain thread.
+    std::string m_pending;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::thread m_thread;
+
+    void wake() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake.notify_one();
+    }
+
+    bool isReady() const {
+        return m_slots[m_head & (LOG_SLOT_COUNT - 1)].seq.load(std::memory_order_acquire) == m_head + 1;
+    }
+
+    void write(const Slot &slot) {
+        if(slot.kind == RecordKind::Barrier) {
+            return;
+        }
+
+        LogSink sink = g_sink.load(std::memory_order_acquire);
+        if(sink != nullptr) {
+            if(slot.first && slot.last) {
+                sink(slot.text, slot.length, g_sinkUser.load(std::memory_order_acquire));
+                return;
+            }
+            if(slot.first) {
+                m_pending.clear();
+            }
+            m_pending.append(slot.text, slot.length);
+            if(slot.last) {
+                sink(m_pending.data(), m_pending.length(), g_sinkUser.load(std::memory_order_acquire));
+            }
+            return;
+        }
+
+        if(slot.first && slot.kind == RecordKind::Comment) {
+            fwrite("C ", 1, 2, stdout);
+        }
+        fwrite(slot.text, 1, slot.length, stdout);
+        if(slot.last && slot.kind != RecordKind::Raw) {
+            fputc('\n', stdout);
+        }
+    }
+
+    void drain() {
+        TRACE_THREAD_NAME("logger");
+
+        while(true) {
+            bool flushNow = false;
+            bool any = false;
+
+            while(this->isReady()) {
+                Slot &slot = m_slots[m_head & (LOG_SLOT_COUNT - 1)];
+                this->write(slot);
+                flushNow = slot.last && (slot.kind == RecordKind::Protocol || slot.kind == RecordKind::Barrier);
+
+                slot.seq.store(m_head + LOG_SLOT_COUNT, std::memory_order_release);
+                m_head++;
+                any = true;
+
+                // Don't hold back protocol output behind a long run of comments.
+                if(flushNow) {
+                    break;
+                }
+            }
+
+            // Flush whenever the queue runs dry, so comments still show up promptly.
+            if(any) {
+                TRACE_SCOPE("log flush");
+                fflush(stdout);
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_written.store(m_head, std::memory_order_release);
+                m_done.notify_all();
+            }
+
+            if(flushNow) {
+                continue;
+            }
+
+            if(m_stop.load(std::memory_order_acquire)) {
+                return;
+            }
+
+            if(!any) {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_sleeping.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                m_wake.wait(lock, [&] {
+                    return this->isReady() || m_stop.load(std::memory_order_acquire);
+                });
+                m_sleeping.store(false, std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+std::atomic<LogLevel> g_level(LogLevel::Info);
+
+LogQueue &queue() {
+    static LogQueue instance;
+    return instance;
+}
+
+}
+
 void Logger::logComment(const std::string &s, bool newLine) {
-    if(newLine) {
-        std::cout << "C " << s << std::endl;
-    } else {
-        std::cout << s;
+    if(!isEnabled(LogLevel::Info)) {
+        return;
     }
+
+    queue().push(newLine ? RecordKind::Comment : RecordKind::Raw, s.data(), s.length());
+}
+
+void Logger::log(LogLevel level, const std::string &s) {
+    if(!isEnabled(level)) {
+        return;
+    }
+
+    queue().push(RecordKind::Comment, s.data(), s.length());
+}
+
+void Logger::writeProtocol(const std::string &line) {
+    TRACE_SCOPE("writeProtocol");
+    LogQueue &q = queue();
+    q.waitFor(q.push(RecordKind::Protocol, line.data(), line.length()));
+}
+
+void Logger::flush() {
+    LogQueue &q = queue();
+    q.waitFor(q.push(RecordKind::Barrier, nullptr, 0));
+}
+
+void Logger::setSink(LogSink sink, void *user) {
+    flush();
+    g_sinkUser.store(user, std::memory_order_release);
+    g_sink.store(sink, std::memory_order_release);
+}
+
+void Logger::discard(const char *, size_t, void *) {}
+
+void Logger::setLevel(LogLevel level) {
+    g_level.store(level, std::memory_order_relaxed);
+}
+
+LogLevel Logger::getLevel() {
+    return g_level.load(std::memory_order_relaxed);
+}
+
+bool Logger::isEnabled(LogLevel level) {
+    return level != LogLevel::Off && level <= g_level.load(std::memory_order_relaxed);
+}
+
+LogLevel Logger::parseLevel(const std::string &name, LogLevel fallback) {
+    if(name == "off") {
+        return LogLevel::Off;
+    } else if(name == "error") {
+        return LogLevel::Error;
+    } else if(name == "warn") {
+        return LogLevel::Warn;
+    } else if(name == "info") {
+        return LogLevel::Info;
+    } else if(name == "debug") {
+        return LogLevel::Debug;
+    }
+
+    return fallback;
 }
@@ -8,6 +8,36 @@
 #include <iostream>
 #include <string.h>
 
+/**
+ * Verbosity levels, from least to most verbose.
+ */
+enum class LogLevel {
+    Off,
+    Error,
+    Warn,
+    Info,
+    Debug
+};
+
+/**
+ * Receives log records in place of stdout: one comment or protocol line per call, without the
+ * "C " prefix or newline. Called from the logger's background thread.
+ */
+typedef void (*LogSink)(const char *text, size_t length, void *user);
+
+/**
+ * Asynchronous stdout logger.
+ *
+ * Records are copied into a fixed-size lock-free ring buffer and written out by a background
+ * thread, so logging never blocks on (or flushes) stdout from the calling thread. Protocol output
+ * for the referee goes through the same queue via writeProtocol, which keeps it strictly ordered
+ * with respect to comments and waits until it has actually been flushed.
+ *
+ * Embedders can redirect everything, protocol lines included, with setSink.
+ *
+ * Debug logging should go through LOG_DEBUG, which compiles away entirely unless
+ * OTHELLO_DEBUG_LOG is defined.
+ */
 class Logger {
 public:
     /**
@@ -16,6 +46,46 @@ public:
     * @param newLine Whether to log a new line and begin a new comment. False to append to existing comment.
     */
     static void logComment(const std::string &s, bool newLine = true);
+    /**
+     * Logs a comment at the given level. Dropped if the level is more verbose than the current level.
+     */
+    static void log(LogLevel level, const std::string &s);
+    /**
+     * Writes a line of referee protocol output (anything that is not a comment).
+     * Returns once the line, and everything logged before it, has been flushed to stdout.
+     */
+    static void writeProtocol(const std::string &line);
+    /**
+     * Blocks until every record queued so far has been written and stdout has been flushed.
+     * Never call this from inside the search.
+     */
+    static void flush();
+
+    /**
+     * Sends all further output to sink instead of stdout. Everything queued before the call is
+     * still written to the previous destination.
+     * @param sink The new destination, or nullptr for stdout.
+     */
+    static void setSink(LogSink sink, void *user);
+    /**
+     * A LogSink that drops everything.
+     */
+    static void discard(const char *text, size_t length, void *user);
+
+    static void setLevel(LogLevel level);
+    static LogLevel getLevel();
+    static bool isEnabled(LogLevel level);
+    /**
+     * Parses "off", "error", "warn", "info" or "debug".
+     * @return The parsed level, or fallback if the name is unknown.
+     */
+    static LogLevel parseLevel(const std::string &name, LogLevel fallback);
 };
 
+#ifdef OTHELLO_DEBUG_LOG
+#define LOG_DEBUG(msg) do { if(Logger::isEnabled(LogLevel::Debug)) { Logger::log(LogLevel::Debug, (msg)); } } while(0)
+#else
+#define LOG_DEBUG(msg) do { } while(0)
+#endif
+
 #endif //OTHELLOPROJECT_CPP_LOGGER_H
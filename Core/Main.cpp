@@ -1,23 +1,345 @@
-#include <bitset>
+#include <ctime>
+#include <memory>
+#include <sstream>
 #include <string.h>
 
+#include "AllocTracker.h"
+#include "Bits.h"
 #include "Logger.h"
+#include "PerfCounters.h"
+#include "Trace.h"
 
 #include "IO/Input/InputHandler.h"
 #include "IO/Output/OutputHandler.h"
+#include "IO/Protocol/EngineProtocol.h"
 
 #include "OthelloGame/BitBoard.h"
 #include "OthelloGame/OthelloGameBoard.h"
 
+#include "Records/GameRecordWriter.h"
+#include "Records/WthorImporter.h"
+
+#include "Search/DfpnSolver.h"
+#include "Search/Mcts.h"
+#include "Search/TranspositionTable.h"
+#include "Search/TreeRecorder.h"
+
+#include "Tools/Annotator.h"
+#include "Tools/BatchBench.h"
+#include "Tools/Match.h"
+#include "Tools/SearchBench.h"
+#include "Tools/TreeAnalyzer.h"
+#include "Tools/Tuner.h"
+
 // Time allotted for each player. Total game time is 2x this value.
 #define DEF_MAX_TIME 120
 
 int main(int argc, char* argv[]) {
     bool interactive = argc > 1 && strcmp(argv[1], "--interactive") == 0;
-    int gameTime = argc > 2 ? std::stoi(argv[2]) : DEF_MAX_TIME;
+    int gameTime = argc > 2 && argv[2][0] != '-' ? std::stoi(argv[2]) : DEF_MAX_TIME;
+
+    const char *logLevel = Utils::getOption(argc, argv, "--log-level");
+    if(logLevel != nullptr) {
+        Logger::setLevel(Logger::parseLevel(logLevel, LogLevel::Info));
+    }
+
+    LOG_DEBUG("Bit operations: " + Bits::describe());
+
+    // Records a timeline of the search, input waits and log flushes, written as Chrome trace JSON at exit.
+    const char *tracePath = Utils::getOption(argc, argv, "--trace");
+    if(tracePath != nullptr) {
+        if(Trace::isCompiledIn()) {
+            TRACE_THREAD_NAME("main");
+            Trace::start(tracePath);
+        } else {
+            Logger::log(LogLevel::Warn, "--trace needs a build with OTHELLO_TRACE defined, not tracing");
+        }
+    }
+
+    // Reports hardware performance counters (IPC, cache, branch and TLB misses) for every search on this thread.
+    if(Utils::hasFlag(argc, argv, "--perf")) {
+        if(!PerfCounters::open()) {
+            Logger::log(LogLevel::Warn, "--perf: no performance counters available on this system");
+        }
+        Logger::log(LogLevel::Info, PerfCounters::getStatus());
+    }
+
+    // Checks the bit manipulation helpers against their portable versions on this host and exits.
+    if(Utils::hasFlag(argc, argv, "--check-bits")) {
+        bool ok = Bits::verify();
+        Logger::writeProtocol(std::string(ok ? "OK " : "FAILED ") + Bits::describe());
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Every finished game is appended to the record files in this directory, if given.
+    const char *recordDir = Utils::getOption(argc, argv, "--record-dir");
+    std::unique_ptr<GameRecordWriter> recorder;
+    if(recordDir != nullptr) {
+        recorder = std::make_unique<GameRecordWriter>(recordDir);
+    }
 
     // Init config
     Config cfg = Config(interactive, gameTime);
+
+    const char *engine = Utils::getOption(argc, argv, "--engine");
+    if(engine != nullptr && strcmp(engine, "mcts") == 0) {
+        cfg.setEngine(EngineType::Mcts);
+    }
+
+    const char *threads = Utils::getOption(argc, argv, "--threads");
+    if(threads != nullptr) {
+        cfg.setThreads(atoi(threads));
+    }
+
+    const char *hash = Utils::getOption(argc, argv, "--hash");
+    if(hash != nullptr) {
+        cfg.setHashMb(atoi(hash));
+    }
+
+    // Search, time and evaluation parameters, see SearchParams: a parameter file first, then single flags.
+    SearchParams searchParams;
+    const char *paramsPath = Utils::getOption(argc, argv, "--params");
+    if(paramsPath != nullptr) {
+        std::string error;
+        if(!searchParams.load(paramsPath, error)) {
+            Logger::log(LogLevel::Error, "Could not load parameters: " + error);
+            return EXIT_FAILURE;
+        }
+    }
+    searchParams.etc = searchParams.etc && !Utils::hasFlag(argc, argv, "--no-etc");
+    searchParams.lmr = searchParams.lmr && !Utils::hasFlag(argc, argv, "--no-lmr");
+    searchParams.lazyEval = searchParams.lazyEval && !Utils::hasFlag(argc, argv, "--no-lazy-eval");
+    const std::pair<const char *, int *> paramOptions[] = {
+            { "--etc-min-draft", &searchParams.etcMinDraft },
+            { "--lmr-min-draft", &searchParams.lmrMinDraft },
+            { "--lmr-min-moves", &searchParams.lmrMinMoves },
+            { "--lmr-reduction", &searchParams.lmrReduction }
+    };
+    for(const auto &option : paramOptions) {
+        const char *value = Utils::getOption(argc, argv, option.first);
+        if(value != nullptr && !Utils::parseInt(value, *option.second)) {
+            Logger::log(LogLevel::Error, std::string(option.first) + ": not a number: " + value);
+            return EXIT_FAILURE;
+        }
+    }
+    // Out of range values are brought into range, the same as in a parameter file.
+    searchParams.clamp();
+    cfg.setSearchParams(searchParams);
+
+    // Replaces the evaluation heuristic with a neural network, if given.
+    const char *nnue = Utils::getOption(argc, argv, "--nnue");
+    if(nnue != nullptr) {
+        if(Nnue::load(nnue)) {
+            Logger::logComment(std::string("Loaded network ") + nnue + " (" + Nnue::getKernelName() + " inference)");
+        } else {
+            Logger::log(LogLevel::Error, std::string("Could not load network ") + nnue + ", using the heuristic");
+        }
+    }
+
+    // Checks incremental accumulator updates and the inference kernels of the --nnue network (or a
+    // random one) against from-scratch results and exits.
+    if(Utils::hasFlag(argc, argv, "--check-nnue")) {
+        if(!Nnue::isLoaded()) {
+            Nnue::loadRandom(0x9E3779B97F4A7C15ULL);
+        }
+        bool ok = Nnue::verify();
+        Logger::writeProtocol(std::string(ok ? "OK" : "FAILED") + " network inference (" + Nnue::getKernelName() +
+                              ") and incremental updates");
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Engine comparison: play N games of the selected engine against alpha-beta and exit.
+    const char *matchGames = Utils::getOption(argc, argv, "--match");
+    if(matchGames != nullptr) {
+        MatchResult result = Match::play(cfg, cfg.getEngine(), EngineType::AlphaBeta, atoi(matchGames));
+        Match::report(result, cfg.getEngine(), EngineType::AlphaBeta);
+        return EXIT_SUCCESS;
+    }
+
+    // Batch environment check and benchmark: play N random games through BatchEnv and exit.
+    const char *batchGames = Utils::getOption(argc, argv, "--batch-bench");
+    if(batchGames != nullptr) {
+        BatchBenchResult result = BatchBench::run(atoi(batchGames));
+        BatchBench::report(result);
+        return result.mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Reports move ordering statistics of a tree file written with --record-tree and exits.
+    const char *analyzeTree = Utils::getOption(argc, argv, "--analyze-tree");
+    if(analyzeTree != nullptr) {
+        TreeAnalysis analysis = TreeAnalyzer::analyze(analyzeTree);
+        for(const std::string &line : TreeAnalyzer::format(analysis)) {
+            Logger::writeProtocol(line);
+        }
+        return analysis.valid ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Writes the top --record-tree-ply plies of every --record-tree-every-th search (search bench or games) to a file.
+    const char *treePath = Utils::getOption(argc, argv, "--record-tree");
+    std::unique_ptr<TreeRecorder> treeRecorder;
+    if(treePath != nullptr) {
+        const char *treePly = Utils::getOption(argc, argv, "--record-tree-ply");
+        const char *treeEvery = Utils::getOption(argc, argv, "--record-tree-every");
+        treeRecorder = std::make_unique<TreeRecorder>(treePath, treePly ? atoi(treePly) : 6, treeEvery ? atoi(treeEvery) : 1);
+        if(!treeRecorder->isOpen()) {
+            Logger::log(LogLevel::Error, "Could not create " + std::string(treePath));
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Search benchmark: fixed-depth searches of a fixed set of positions, reporting nodes and pruning statistics.
+    const char *benchDepth = Utils::getOption(argc, argv, "--search-bench");
+    if(benchDepth != nullptr) {
+        const char *benchPositions = Utils::getOption(argc, argv, "--bench-positions");
+        SearchBenchResult result = SearchBench::run(cfg, atoi(benchDepth), benchPositions ? atoi(benchPositions) : 20,
+                                                    1, treeRecorder.get());
+        SearchBench::report(result);
+        return EXIT_SUCCESS;
+    }
+
+    // Allocation check: fixed-depth searches that must not allocate in the tree once warmed up.
+    const char *allocDepth = Utils::getOption(argc, argv, "--check-allocs");
+    if(allocDepth != nullptr) {
+        if(!AllocTracker::isCompiledIn()) {
+            Logger::log(LogLevel::Error, "--check-allocs needs a build with OTHELLO_ALLOC_TRACK defined");
+            return EXIT_FAILURE;
+        }
+        const char *benchPositions = Utils::getOption(argc, argv, "--bench-positions");
+        AllocCheckResult result = SearchBench::checkAllocations(cfg, atoi(allocDepth), benchPositions ? atoi(benchPositions) : 20);
+        return SearchBench::reportAllocations(result) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Proof-number solver: proves random positions with this many empties and checks them against a plain search.
+    const char *solverEmpties = Utils::getOption(argc, argv, "--check-solver");
+    const char *solveTime = Utils::getOption(argc, argv, "--solve-time");
+    if(solverEmpties != nullptr) {
+        const char *benchPositions = Utils::getOption(argc, argv, "--bench-positions");
+        SolverCheckResult result = SearchBench::checkSolver(cfg, atoi(solverEmpties), benchPositions ? atoi(benchPositions) : 20,
+                                                            solveTime ? atoll(solveTime) : 10000);
+        return SearchBench::reportSolver(result) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Proves the outcome of one position: 64 characters a1..h1 then a2..h8 (B / W / -) and b or w for the
+    // side to move. Runs until proven unless --solve-time is given.
+    const char *solvePosition = Utils::getOption(argc, argv, "--solve");
+    if(solvePosition != nullptr) {
+        uint64_t black = 0, white = 0;
+        bool valid = strlen(solvePosition) == 65 && (solvePosition[64] == 'b' || solvePosition[64] == 'w');
+        for(int i = 0; valid && i < 64; i++) {
+            // Text index i is square a1 + i, which is bit 63 - i.
+            char c = solvePosition[i];
+            if(c == 'B') {
+                black |= 1ULL << (63 - i);
+            } else if(c == 'W') {
+                white |= 1ULL << (63 - i);
+            } else {
+                valid = c == '-';
+            }
+        }
+        if(!valid) {
+            Logger::log(LogLevel::Error, "--solve needs 64 squares of B, W or - followed by b or w");
+            return EXIT_FAILURE;
+        }
+
+        bool blackToMove = solvePosition[64] == 'b';
+        DfpnSolver solver(cfg.getHashMb());
+        SearchContext ctx;
+        SearchContext::Clock::time_point deadline = solveTime != nullptr ?
+                SearchContext::now() + std::chrono::milliseconds(atoll(solveTime)) : SearchContext::Clock::time_point::max();
+        DfpnResult result = solver.solve(blackToMove ? black : white, blackToMove ? white : black, deadline, ctx);
+
+        Logger::writeProtocol(std::string(blackToMove ? "Black" : "White") + " to move: " +
+                              DfpnSolver::getOutcomeName(result.outcome) +
+                              (result.move >= 0 ? " with " + Utils::posToSquare(result.move) : "") + ", " +
+                              std::to_string(result.nodes) + " nodes in " + std::to_string(result.timeMs) + "ms, " +
+                              std::to_string(result.collections) + " table collections, table " +
+                              std::to_string(result.usage / 10) + "% full");
+        return result.outcome != DfpnOutcome::Unknown ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // SPSA tuning of the parameters above with fast games at this game time. The result is written to --tune-output.
+    const char *tuneIterations = Utils::getOption(argc, argv, "--tune");
+    if(tuneIterations != nullptr) {
+        TunerOptions options;
+        options.iterations = atoi(tuneIterations);
+        options.threads = cfg.getThreads();
+        const char *pairs = Utils::getOption(argc, argv, "--tune-pairs");
+        if(pairs != nullptr) {
+            options.pairs = std::max(1, atoi(pairs));
+        }
+        const char *output = Utils::getOption(argc, argv, "--tune-output");
+        if(output != nullptr) {
+            options.output = output;
+        }
+        // Comma-separated names, see SearchParams::getSpecs.
+        const char *names = Utils::getOption(argc, argv, "--tune-params");
+        if(names != nullptr) {
+            std::stringstream list(names);
+            for(std::string name; std::getline(list, name, ',');) {
+                options.params.push_back(name);
+            }
+        }
+
+        Tuner::run(cfg, options);
+        Logger::writeProtocol("Wrote " + options.output);
+        return EXIT_SUCCESS;
+    }
+
+    // WTHOR import: replays every game of the given archives (files, directories or a comma-separated list),
+    // writing them as game records and / or a position store.
+    const char *wthor = Utils::getOption(argc, argv, "--import-wthor");
+    if(wthor != nullptr) {
+        WthorImportOptions options;
+        options.threads = cfg.getThreads();
+        const char *recordsOut = Utils::getOption(argc, argv, "--import-records");
+        options.recordDir = recordsOut != nullptr ? recordsOut : "";
+        const char *positionsOut = Utils::getOption(argc, argv, "--import-positions");
+        options.positionPath = positionsOut != nullptr ? positionsOut : "";
+        const char *maxPly = Utils::getOption(argc, argv, "--import-max-ply");
+        if(maxPly != nullptr) {
+            options.maxPositionPly = atoi(maxPly);
+        }
+
+        WthorImportResult result = WthorImporter::run(WthorImporter::listFiles(wthor), options);
+        WthorImporter::report(result);
+        return result.files > result.badFiles ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Game review: annotates every ply of the recorded games (a record file or directory) with the engine's
+    // score, best move and the loss of the move played. Fixed depth unless --annotate-time is given.
+    const char *annotate = Utils::getOption(argc, argv, "--annotate");
+    if(annotate != nullptr) {
+        AnnotateOptions options;
+        options.threads = cfg.getThreads();
+        const char *depth = Utils::getOption(argc, argv, "--annotate-depth");
+        const char *moveTime = Utils::getOption(argc, argv, "--annotate-time");
+        if(moveTime != nullptr) {
+            options.limits.moveTimeMs = atoi(moveTime);
+        }
+        if(depth != nullptr || moveTime == nullptr) {
+            options.limits.depth = depth != nullptr ? atoi(depth) : 10;
+        }
+        const char *mistake = Utils::getOption(argc, argv, "--annotate-mistake");
+        if(mistake != nullptr) {
+            options.mistakeLoss = atoi(mistake);
+        }
+
+        std::vector<GameRecord> games = Annotator::loadGames(annotate);
+        if(games.empty()) {
+            Logger::log(LogLevel::Error, std::string("No game records in ") + annotate);
+            return EXIT_FAILURE;
+        }
+        Annotator::run(cfg, games, options);
+        return EXIT_SUCCESS;
+    }
+
+    // Engine control protocol instead of the referee protocol.
+    if(Utils::hasFlag(argc, argv, "--protocol")) {
+        EngineProtocol protocol(cfg);
+        protocol.run();
+        return EXIT_SUCCESS;
+    }
+
     int agentColor;
     int opponentColor;
 
@@ -46,8 +368,8 @@ int main(int argc, char* argv[]) {
 
             break;
         } else {
-            Logger::logComment("Something went wrong during initialization!");
-            Logger::logComment("Expected: 'I B' or 'I W' -- received: " + input);
+            Logger::log(LogLevel::Warn, "Something went wrong during initialization!");
+            Logger::log(LogLevel::Warn, "Expected: 'I B' or 'I W' -- received: " + input);
         }
     }
 
@@ -55,6 +377,41 @@ int main(int argc, char* argv[]) {
     BitBoard opponentBoard = BitBoard(opponentColor);
     OthelloGameBoard gameBoard = OthelloGameBoard(cfg, agentColor, agentBoard, opponentBoard);
 
+    std::unique_ptr<Mcts> mcts;
+    if(cfg.getEngine() == EngineType::Mcts) {
+        mcts = std::make_unique<Mcts>(MCTS_DEFAULT_NODES, cfg.getThreads());
+    }
+
+    // The transposition table is kept for the whole game. With a snapshot file it also starts
+    // from, and is saved back to, the results of earlier games.
+    TranspositionTable tt(cfg.getHashMb());
+    const char *hashFile = Utils::getOption(argc, argv, "--hash-file");
+    if(hashFile != nullptr) {
+        if(tt.load(hashFile, cfg.getSearchParams(), Utils::hasFlag(argc, argv, "--hash-readonly"))) {
+            Logger::logComment("Loaded hash snapshot " + std::string(hashFile) + " (" +
+                               std::to_string(tt.getCapacity()) + " entries, " +
+                               std::to_string(tt.getUsage() / 10) + "% used)");
+        } else {
+            Logger::log(LogLevel::Warn, "No usable hash snapshot at " + std::string(hashFile) + ", starting empty");
+        }
+    }
+
+    DfpnSolver solver;
+
+    SearchContext searchContext;
+    searchContext.setTable(&tt);
+    searchContext.setSolver(&solver);
+    searchContext.setRecorder(treeRecorder.get());
+    searchContext.setParams(cfg.getSearchParams());
+
+    auto selectMove = [&](int color) {
+        if(mcts) {
+            return mcts->selectMove(gameBoard, color);
+        }
+        searchContext.reset();
+        return gameBoard.selectMove(color, SearchLimits(), searchContext);
+    };
+
     Logger::logComment("Gameboard initialized.");
     gameBoard.drawBoard();
 
@@ -64,6 +421,10 @@ int main(int argc, char* argv[]) {
     bool playAsBlack = agentColor == BLACK;
     bool blackTurn = true;
 
+    GameRecord record;
+    record.agentColor = (int8_t) agentColor;
+    record.gameTime = (uint16_t) gameTime;
+
     while(!gameBoard.isGameComplete()) {
         agentBoard = gameBoard.getPlayer();
         opponentBoard = gameBoard.getOpponent();
@@ -72,12 +433,16 @@ int main(int argc, char* argv[]) {
         Logger::logComment(prompt);
 
         Directive newDirective;
+        Move played;
+        MoveStats stats;
+        bool searched = true;
 
         bool agentTurn = playAsBlack && blackTurn || !playAsBlack && !blackTurn;
 
         // Agent makes a move.
         if(agentTurn) {
-            Move move = gameBoard.selectMove(agentColor, false);
+            Move move = selectMove(agentColor);
+            played = move;
 
             // Apply move to board if not passing
             if(!move.isPass()) {
@@ -101,7 +466,7 @@ int main(int argc, char* argv[]) {
                 bool valid = (possibleMoves > 0 && ((1LL << move.getPos()) & possibleMoves) != 0) || (move.isPass() && possibleMoves == 0);
 
                 while(!valid) {
-                    Logger::logComment("Invalid move, please try again.");
+                    Logger::log(LogLevel::Warn, "Invalid move, please try again.");
 
                     input = InputHandler::readInput();
                     move = OutputHandler::toMove(input);
@@ -109,15 +474,18 @@ int main(int argc, char* argv[]) {
                     valid = ((1LL << move.getPos()) & possibleMoves) != 0;
                 }
 
+                searched = false;
+
             } else {
                 // "Player" (agent) makes a move if not m_interactive
-                move = gameBoard.selectMove(opponentColor, false);
+                move = selectMove(opponentColor);
             }
 
             // Apply move to board if not passing.
             if(!move.isPass()) {
                 gameBoard.applyMove(opponentBoard, move);
             }
+            played = move;
 
             input = OutputHandler::getMoveOutput(opponentColor, move, true);
             newDirective = InputHandler::identifyDirective(input, opponentColor);
@@ -129,10 +497,19 @@ int main(int argc, char* argv[]) {
         }
 
         if(newDirective == Directive::Invalid) {
-            Logger::logComment("Invalid move! Try again.");
+            Logger::log(LogLevel::Warn, "Invalid move! Try again.");
             continue;
         }
 
+        if(searched) {
+            const SearchInfo &info = mcts ? mcts->getLastSearchInfo() : gameBoard.getLastSearchInfo();
+            stats.score = info.score;
+            stats.depth = (uint8_t) std::min(info.depth, 255);
+            stats.nodes = info.nodes;
+            stats.timeMs = (uint32_t) info.timeMs;
+        }
+        record.addMove(played.getPos(), &stats);
+
         gameBoard.drawBoard();
         blackTurn = !blackTurn;
 
@@ -143,7 +520,22 @@ int main(int argc, char* argv[]) {
 
     // End of game output
     int f_black = gameBoard.countPieces(BLACK);
-    std::cout << f_black << std::endl;
+
+    if(recorder) {
+        record.blackDiscs = (uint8_t) f_black;
+        record.whiteDiscs = (uint8_t) gameBoard.countPieces(WHITE);
+        record.timestamp = (uint32_t) std::time(nullptr);
+
+        if(!recorder->append(record) || !recorder->flush()) {
+            Logger::log(LogLevel::Error, "Failed to write game record to " + recorder->currentPath());
+        }
+    }
+
+    if(hashFile != nullptr && !tt.isReadOnly() && !mcts && !tt.save(hashFile, cfg.getSearchParams())) {
+        Logger::log(LogLevel::Error, "Failed to save hash snapshot to " + std::string(hashFile));
+    }
+
+    Logger::writeProtocol(std::to_string(f_black));
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "BitBoard.h"
 #include "Color.h"
+#include "../Bits.h"
 
 #define BLACK_BITS 0x0000000810000000
 #define WHITE_BITS 0x0000001008000000
@@ -36,15 +37,7 @@ bool BitBoard::getCellState(int pos) {
 }
 
 int BitBoard::getCellCount() {
-    int count = 0;
-    uint64_t curBits = this->getBits();
-
-    while(curBits != 0) {
-        curBits &= curBits - 1;
-        count++;
-    }
-
-    return count;
+    return Bits::popcount(this->getBits());
 }
 
 void BitBoard::setBits(uint64_t bits) {
@@ -0,0 +1,38 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_EVALTERMS_H
+#define OTHELLOPROJECT_CPP_EVALTERMS_H
+
+/**
+ * Evaluation terms that only change on the squares a move touches. OthelloGameBoard keeps them
+ * up to date from the flip mask as moves are applied, so evaluate() only has to do the work that
+ * depends on the whole board (mobility).
+ *
+ * Index 0 is the player (AI), index 1 the opponent.
+ */
+struct EvalTerms {
+    int discs[2] = {0, 0};
+    /**
+     * WEIGHT_MAP sums, plus the bonus for corner-adjacent squares held together with their corner.
+     */
+    int posWeight[2] = {0, 0};
+    int corners[2] = {0, 0};
+    /**
+     * Corner-adjacent squares held, less those held together with their corner.
+     */
+    int adjCorners[2] = {0, 0};
+
+    bool operator==(const EvalTerms &other) const {
+        for(int i = 0; i < 2; i++) {
+            if(discs[i] != other.discs[i] || posWeight[i] != other.posWeight[i] ||
+               corners[i] != other.corners[i] || adjCorners[i] != other.adjCorners[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+#endif //OTHELLOPROJECT_CPP_EVALTERMS_H
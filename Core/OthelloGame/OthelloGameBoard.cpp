@@ -3,10 +3,30 @@
 //
 
 #include "OthelloGameBoard.h"
+#include "../Search/DfpnSolver.h"
+#include "../Search/TranspositionTable.h"
+#include "../Search/TreeRecorder.h"
+#include "../Search/Watchdog.h"
+#include "../Search/Zobrist.h"
+#include "../AllocTracker.h"
+#include "../PerfCounters.h"
+#include "../Trace.h"
+
+#include <cassert>
+#include <memory>
 
 #define DIRECTION_COUNT 8
 #define UNIVERSE 0xffffffffffffffffULL
 
+// The hard deadline is the move budget plus 1 / HARD_DEADLINE_GRACE_DIV of it.
+#define HARD_DEADLINE_GRACE_DIV 4
+// No new iteration is started once 1 / NEXT_ITERATION_TIME_DIV of the budget is used up.
+#define NEXT_ITERATION_TIME_DIV 2
+// Stop early when the best move has not changed for this many iterations...
+#define EASY_MOVE_STABLE_ITERATIONS 3
+// ...and beats every other move by at least this much.
+#define EASY_MOVE_MARGIN 3000
+
 #define CORNER_MASK 0x8100000000000081
 #define CORNER_ADJACENT_MASK 0x42C300000000C342
 
@@ -41,12 +61,74 @@ const std::map<int, std::array<int, 3>> STABILITY_IGNORES = {
         { 62, std::array<int, 3> { 62, 55, 54 }, }
 };
 
+// STABILITY_IGNORES in a form that is cheap to walk on every move.
+struct CornerRegion {
+    uint64_t corner;
+    std::array<int, 3> adjacents;
+    // The corner and its adjacents; a move touching none of these leaves the region's terms unchanged.
+    uint64_t mask;
+};
+
+const std::vector<CornerRegion> CORNER_REGIONS = [] {
+    std::vector<CornerRegion> regions;
+    for(const auto &entry : STABILITY_IGNORES) {
+        CornerRegion region{1ULL << entry.first, entry.second, 1ULL << entry.first};
+        for(int adjacent : entry.second) {
+            region.mask |= 1ULL << adjacent;
+        }
+        regions.push_back(region);
+    }
+    return regions;
+}();
+
+// Table scores are from the side to move's point of view. A score from the other side's is negated,
+// which turns an upper bound into a lower bound and vice versa.
+static inline TTBound flipBound(TTBound bound) {
+    return bound == TTBound::Upper ? TTBound::Lower : bound == TTBound::Lower ? TTBound::Upper : bound;
+}
+
+// Converts an entry probed for a node to the searching player's point of view.
+static inline void toPlayerView(TTEntry &entry, bool playerToMove) {
+    if(!playerToMove) {
+        entry.score = -entry.score;
+        entry.bound = flipBound(entry.bound);
+    }
+}
+
+static inline void storeForMover(TranspositionTable *tt, uint64_t key, int score, int move, int draft, TTBound bound,
+                                 bool playerToMove) {
+    tt->store(key, playerToMove ? score : -score, move, draft, playerToMove ? bound : flipBound(bound));
+}
+
+// Negates a score, keeping the INT32_MIN / INT32_MAX window ends infinite.
+static inline int negateScore(int score) {
+    return score == INT32_MIN ? INT32_MAX : score == INT32_MAX ? INT32_MIN : -score;
+}
+
+// Fills in the window and result of a finished node, from the side to move's point of view, and records it.
+static void recordNode(TreeRecorder *recorder, TreeRecord &record, int alpha, int beta, int score, bool playerToMove,
+                       uint64_t nodes) {
+    record.alpha = playerToMove ? alpha : negateScore(beta);
+    record.beta = playerToMove ? beta : negateScore(alpha);
+    record.score = playerToMove ? score : negateScore(score);
+    record.nodes = (uint32_t) std::min<uint64_t>(nodes, UINT32_MAX);
+    recorder->add(record);
+}
+
 OthelloGameBoard::OthelloGameBoard(Config cfg, int playerColor, BitBoard player, BitBoard opponent) :
-        m_cfg(cfg), m_playerColor(playerColor), m_playerBoard(player), m_opponentBoard(opponent) {}
+        m_cfg(cfg), m_playerColor(playerColor), m_playerBoard(player), m_opponentBoard(opponent),
+        m_terms(computeEvalTerms(player.getBits(), opponent.getBits())),
+        m_hash(Zobrist::compute(player.getBits(), opponent.getBits())),
+        m_opponentHash(Zobrist::compute(opponent.getBits(), player.getBits())) {
+    if(Nnue::isLoaded()) {
+        Nnue::refresh(m_acc, m_playerBoard.getBits(), m_opponentBoard.getBits());
+    }
+}
 
 OthelloGameBoard::OthelloGameBoard(const OthelloGameBoard &gameBoard) :
         m_cfg(gameBoard.getCfg()), m_playerColor(gameBoard.m_playerColor), m_playerBoard(gameBoard.m_playerBoard),
-        m_opponentBoard(gameBoard.m_opponentBoard) {}
+        m_opponentBoard(gameBoard.m_opponentBoard), m_acc(gameBoard.m_acc),
+        m_terms(gameBoard.m_terms), m_hash(gameBoard.m_hash), m_opponentHash(gameBoard.m_opponentHash) {}
 
 void OthelloGameBoard::drawBoard() {
     drawBoard(*this);
@@ -59,22 +141,23 @@ void OthelloGameBoard::drawBoard(OthelloGameBoard gameBoard) {
     BitBoard blackBoard = gameBoard.getForColor(BLACK);
     BitBoard whiteBoard = gameBoard.getForColor(WHITE);
 
+    // Each row is built up and logged as a single comment.
+    std::string row;
     for (int i = 63; i >= 0; i--) {
         if (i % 8 == 7) {
-            // We need to use manual prints in this specific case.
-            std::cout << "C " << (-(i / 8) + 8) << " * ";
+            row = std::to_string(-(i / 8) + 8) + " * ";
         }
 
         if (blackBoard.getCellState(i)) {
-            Logger::logComment("B ", false);
+            row += "B ";
         } else if (whiteBoard.getCellState(i)) {
-            Logger::logComment("W ", false);
+            row += "W ";
         } else {
-            Logger::logComment("- ", false);
+            row += "- ";
         }
 
         if (i % 8 == 0) {
-            std::cout << std::endl;
+            Logger::logComment(row);
         }
     }
 }
@@ -115,17 +198,15 @@ bool OthelloGameBoard::isGameComplete(OthelloGameBoard gameBoard) {
 
 int OthelloGameBoard::countPieces(int color) {
     BitBoard toCount = color == this->getPlayerColor() ? this->getPlayer() : this->getOpponent();
-    auto bitset = std::bitset<64>(toCount.getBits());
-    return bitset.count();
+    return Bits::popcount(toCount.getBits());
 }
 
-int OthelloGameBoard::countBits(uint64_t bits) {
-    std::bitset<64> bitset = std::bitset<64>(bits);
-    return bitset.count();
+BITS_DISPATCH int OthelloGameBoard::countBits(uint64_t bits) {
+    return Bits::popcount(bits);
 }
 
 // Credit to Dr. Mec for this algorithm.
-uint64_t OthelloGameBoard::generateMoveMask(uint64_t playerDisks, uint64_t oppDisks) {
+BITS_DISPATCH uint64_t OthelloGameBoard::generateMoveMask(uint64_t playerDisks, uint64_t oppDisks) {
     // Returns move mask
     uint64_t emptyMask = ~playerDisks & ~oppDisks;
     uint64_t holdMask, dirMoveMask, moveMask = 0;
@@ -162,14 +243,8 @@ uint64_t OthelloGameBoard::generateMoveMask(uint64_t playerDisks, uint64_t oppDi
     return moveMask;
 }
 
-void OthelloGameBoard::lineCap(BitBoard board, Move move) {
-    // Move is already applied when running this function.
-    BitBoard opp = this->getForColor(-board.getColor());
-
-    uint64_t selfBits = board.getBits();
-    uint64_t oppBits = opp.getBits();
-
-    uint64_t mask = 1LL << move.getPos();
+BITS_DISPATCH uint64_t OthelloGameBoard::getFlips(uint64_t playerDisks, uint64_t oppDisks, int pos) {
+    uint64_t mask = 1LL << pos;
     uint64_t f_fin = 0LL;
 
     uint64_t possibility;
@@ -184,7 +259,7 @@ void OthelloGameBoard::lineCap(BitBoard board, Move move) {
             search = (mask >> -DIR_INCREMENTS[i]) & DIR_MASKS[i];
         }
 
-        possibility = oppBits & search;
+        possibility = oppDisks & search;
 
         // Keep moving forward, identifying bits to flip
         // If we are in this loop, there's an opponent piece here.
@@ -197,15 +272,60 @@ void OthelloGameBoard::lineCap(BitBoard board, Move move) {
                 search = (search >> -DIR_INCREMENTS[i]) & DIR_MASKS[i];
             }
 
-            if ((selfBits & search) != 0) {
+            if ((playerDisks & search) != 0) {
                 f_fin |= to_change;
                 break;
             }
 
-            possibility = oppBits & search;
+            possibility = oppDisks & search;
         }
     }
 
+    return f_fin;
+}
+
+void OthelloGameBoard::lineCap(BitBoard board, Move move) {
+    // Move is already applied when running this function.
+    BitBoard opp = this->getForColor(-board.getColor());
+
+    uint64_t selfBits = board.getBits();
+    uint64_t oppBits = opp.getBits();
+
+    uint64_t f_fin = getFlips(selfBits, oppBits, move.getPos());
+
+    bool byPlayer = board.getColor() == m_playerColor;
+    if(Nnue::isLoaded()) {
+        Nnue::update(m_acc, byPlayer, move.getPos(), f_fin);
+    }
+
+    // Only the placed square and the flipped discs change, so update the evaluation terms from those.
+    uint64_t placed = 1ULL << move.getPos();
+    uint64_t touched = placed | f_fin;
+    int self = byPlayer ? 0 : 1;
+    int other = 1 - self;
+
+    if(touched & CORNER_ADJACENT_MASK) {
+        uint64_t before = selfBits & ~placed;
+        addCornerRegions(m_terms, byPlayer ? before : oppBits, byPlayer ? oppBits : before, touched, -1);
+    }
+
+    int flipCount = countBits(f_fin);
+    int flipWeight = 0;
+    Bits::forEach(f_fin, [&](int pos) {
+        flipWeight += WEIGHT_MAP[pos];
+    });
+    m_hash ^= Zobrist::moveDelta(self, move.getPos(), f_fin);
+    m_opponentHash ^= Zobrist::moveDelta(other, move.getPos(), f_fin);
+
+    m_terms.discs[self] += flipCount + 1;
+    m_terms.discs[other] -= flipCount;
+    m_terms.posWeight[self] += WEIGHT_MAP[move.getPos()] + flipWeight;
+    m_terms.posWeight[other] -= flipWeight;
+    m_terms.corners[self] += countBits(touched & CORNER_MASK);
+    m_terms.corners[other] -= countBits(f_fin & CORNER_MASK);
+    m_terms.adjCorners[self] += countBits(touched & CORNER_ADJACENT_MASK);
+    m_terms.adjCorners[other] -= countBits(f_fin & CORNER_ADJACENT_MASK);
+
     selfBits |= f_fin;
     oppBits = (~f_fin) & oppBits;
 
@@ -214,6 +334,61 @@ void OthelloGameBoard::lineCap(BitBoard board, Move move) {
 
     this->setForColor(board);
     this->setForColor(opp);
+
+    if(touched & CORNER_ADJACENT_MASK) {
+        addCornerRegions(m_terms, m_playerBoard.getBits(), m_opponentBoard.getBits(), touched, 1);
+    }
+}
+
+BITS_DISPATCH EvalTerms OthelloGameBoard::computeEvalTerms(uint64_t player, uint64_t opponent) {
+    EvalTerms terms;
+    uint64_t sides[2] = {player, opponent};
+
+    for(int s = 0; s < 2; s++) {
+        terms.discs[s] = Bits::popcount(sides[s]);
+        terms.corners[s] = Bits::popcount(sides[s] & CORNER_MASK);
+        terms.adjCorners[s] = Bits::popcount(sides[s] & CORNER_ADJACENT_MASK);
+
+        Bits::forEach(sides[s], [&](int pos) {
+            terms.posWeight[s] += WEIGHT_MAP[pos];
+        });
+    }
+
+    addCornerRegions(terms, player, opponent, UNIVERSE, 1);
+    return terms;
+}
+
+void OthelloGameBoard::addCornerRegions(EvalTerms &terms, uint64_t player, uint64_t opponent, uint64_t touched,
+                                        int sign) {
+    /**
+     * Once a corner is captured, the negative weight of the positions listed next to it in
+     * STABILITY_IGNORES becomes irrelevant: they no longer count as corner-adjacent, and
+     * their stability value is re-added, as they now have positive weight instead.
+     */
+    for(const CornerRegion &region : CORNER_REGIONS) {
+        if((region.mask & touched) == 0) {
+            continue;
+        }
+
+        int s;
+        uint64_t owner;
+        if(player & region.corner) {
+            s = 0;
+            owner = player;
+        } else if(opponent & region.corner) {
+            s = 1;
+            owner = opponent;
+        } else {
+            continue;
+        }
+
+        for(int adjacent : region.adjacents) {
+            if(owner & (1ULL << adjacent)) {
+                terms.adjCorners[s] -= sign;
+                terms.posWeight[s] += sign * std::abs(WEIGHT_MAP[adjacent] * 2);
+            }
+        }
+    }
 }
 
 // Helper to evaluate
@@ -248,29 +423,54 @@ double OthelloGameBoard::getSumWeight(int p_amt, int o_amt) {
 }
 
 int OthelloGameBoard::evaluate() {
+    return this->evaluate(INT32_MIN, INT32_MAX, nullptr);
+}
+
+BITS_DISPATCH int OthelloGameBoard::evaluate(int alpha, int beta, SearchStats *stats) {
     BitBoard pBoard = this->getPlayer();
     BitBoard oBoard = this->getOpponent();
 
-    double wParity, wCorners, wAdjCorners, wMobility, wStability;
+    // Opt-in: everything kept up to date by applyMove is recomputed from scratch and compared, at a
+    // cost of several times the evaluation itself.
+#ifdef OTHELLO_CHECK_INCREMENTAL
+    assert(m_hash == Zobrist::compute(pBoard.getBits(), oBoard.getBits()));
+    assert(m_opponentHash == Zobrist::compute(oBoard.getBits(), pBoard.getBits()));
+#endif
+
+    if(Nnue::isLoaded() && (pBoard.getBits() | oBoard.getBits()) != UNIVERSE) {
+#ifdef OTHELLO_CHECK_INCREMENTAL
+        NnueAccumulator fresh;
+        Nnue::refresh(fresh, pBoard.getBits(), oBoard.getBits());
+        assert(memcmp(fresh.values, m_acc.values, sizeof(fresh.values)) == 0);
+#endif
+        return Nnue::evaluate(m_acc);
+    }
 
-    int pCount = pBoard.getCellCount();
-    int oCount = oBoard.getCellCount();
+#ifdef OTHELLO_CHECK_INCREMENTAL
+    assert(m_terms == computeEvalTerms(pBoard.getBits(), oBoard.getBits()));
+#endif
 
-    uint64_t pMovesPossible = this->generateMoveMask(pBoard.getBits(), oBoard.getBits());
-    uint64_t oMovesPossible = this->generateMoveMask(oBoard.getBits(), pBoard.getBits());
+    double wParity, wCorners, wAdjCorners, wMobility, wStability;
 
-    // Individual position weight
-    int pPosWeight = 0;
-    int oPosWeight = 0;
+    int pCount = m_terms.discs[0];
+    int oCount = m_terms.discs[1];
 
-    uint64_t pCornerMask = pBoard.getBits() & CORNER_MASK;
-    uint64_t oCornerMask = oBoard.getBits() & CORNER_MASK;
+    // End game. Return below for confirmed win / loss.
+    int sumMoves = pCount + oCount;
+    if(sumMoves == 64) {
+        if(pCount < oCount) {
+            return -1000000 * (oCount - pCount);
+        } else {
+            return 1000000 * (pCount - oCount);
+        }
+    }
 
-    uint64_t pAdjCornerMask = pBoard.getBits() & CORNER_ADJACENT_MASK;
-    uint64_t oAdjCornerMask = oBoard.getBits() & CORNER_ADJACENT_MASK;
+    // Individual position weight, including the stability bonus for captured corner regions.
+    int pPosWeight = m_terms.posWeight[0];
+    int oPosWeight = m_terms.posWeight[1];
 
-    int pCorners = countBits(pCornerMask);
-    int oCorners = countBits(oCornerMask);
+    int pCorners = m_terms.corners[0];
+    int oCorners = m_terms.corners[1];
 
     // Give a bonus corner to opponent for the case that
     // both opponent and player have at least one corner.
@@ -280,75 +480,78 @@ int OthelloGameBoard::evaluate() {
         oCorners += 1;
     }
 
-    int pAdjCorners = countBits(pAdjCornerMask);
-    int oAdjCorners = countBits(oAdjCornerMask);
+    int pAdjCorners = m_terms.adjCorners[0];
+    int oAdjCorners = m_terms.adjCorners[1];
 
-    for(int i = 0; i < 64; i++) {
-        uint64_t mask = 1LL << i;
-        int weight = WEIGHT_MAP[i];
-        if((mask & pBoard.getBits()) != 0) {
-            pPosWeight += weight;
-        } else if((mask & oBoard.getBits()) != 0) {
-            oPosWeight += weight;
-        }
+    const SearchParams &params = this->m_cfg.getSearchParams();
+    int fCorners = params.cornerWeight;
+    int fAdjacent = params.adjacentWeight;
+    int fMobility = params.mobilityWeight;
+    int fParity = params.parityWeight;
+    int fStability = params.stabilityWeight;
+
+    if(sumMoves >= params.parityEndgameDiscs) {
+        fParity = params.parityEndgameWeight;
     }
 
+    wStability = getSumWeight(pPosWeight, oPosWeight);
+    wParity = getSumWeight(pCount, oCount);
+    wCorners = getSumWeight(pCorners, oCorners);
+    wAdjCorners = -getSumWeight(pAdjCorners, oAdjCorners);
+
     /**
-     * Compares player boards with corners listed in STABILITY_IGNORES.
-     * If the corner is set, then the three values inside of the array matched
-     * to the key (corner pos) are checked against the player boards as well.
-     *
-     * We decrement the value of the pAdjCorners/oAdjCorners because once we have
-     * captured a corner, the negative weight assigned to those values becomes irrelevant.
-     *
-     * We also want to re-add the stability value of such positions, as they actually
-     * now have positive weight instead of negative weight.
+     * Mobility is the only term that depends on the whole board, and costs a move generation per side.
+     * Every other term is kept up to date by applyMove, so they are summed first, and mobility is only
+     * computed once its range could still bring the score into the window. A score that cannot is
+     * returned as the bound that proves it (fail-soft), one point wider than the range for rounding.
      */
-    for(auto iterator = STABILITY_IGNORES.begin(); iterator != STABILITY_IGNORES.end(); ++iterator) {
-        int cornerKey = iterator->first;
-        std::array<int, 3> adjacents = iterator->second;
-
-        uint64_t mask = 1LL << cornerKey;
-
-        // Do we have a corner set?
-        if((pBoard.getBits() & mask) != 0) {
-            for(auto adjacentIter = adjacents.begin(); adjacentIter != adjacents.end(); ++adjacentIter) {
-                // If so, iterate through pos's that we defined as adjacent to
-                // said corner in STABILITY_IGNORES.
-                uint64_t curAdjMask = 1LL << (*adjacentIter);
-                if((pBoard.getBits() & curAdjMask) != 0) {
-                    // Decrement adjacent corner count and increase stability score
-                    // if an area adjacent to a set corner is also captured.
-                    pAdjCorners -= 1;
-                    pPosWeight += std::abs(WEIGHT_MAP[*adjacentIter] * 2);
-                }
-            }
-        } else if((oBoard.getBits() & mask) != 0) {
-            for(auto adjacentIter = adjacents.begin(); adjacentIter != adjacents.end(); ++adjacentIter) {
-                uint64_t curAdjMask = 1LL << (*adjacentIter);
-                if((oBoard.getBits() & curAdjMask) != 0) {
-                    oAdjCorners -= 1;
-                    oPosWeight += std::abs(WEIGHT_MAP[*adjacentIter] * 2);
-                }
-            }
+    double others = (int) (fCorners * wCorners) + (fAdjacent * wAdjCorners) + (fParity * wParity) +
+                    (fStability * wStability);
+    auto outside = [&](double low, double high, uint64_t &exits, int &bound) {
+        int upper = (int) (others + fMobility * high) + 1;
+        int lower = (int) (others + fMobility * low) - 1;
+        if(upper <= alpha || lower >= beta) {
+            exits++;
+            bound = upper <= alpha ? upper : lower;
+            return true;
+        }
+        return false;
+    };
+
+    int bound;
+    if(stats != nullptr) {
+        stats->lazyEvals++;
+        // Forced passes weigh 1000 either way.
+        if(outside(-1000, 1000, stats->lazyCheapExits, bound)) {
+            return bound;
         }
     }
 
-    int fCorners = 100;
-    int fAdjacent = 60;
-    int fMobility = 40;
-    int fParity = 20;
-    int fStability = 5;
-
-    int sumMoves = pCount + oCount;
-    if(sumMoves >= 58) {
-        fParity = 75;
+    /**
+     * One side's moves narrow the range enough for most exits: with a move of our own, mobility is
+     * above -100 (or 1000 if the opponent has to pass), which proves fail-highs; with a move for the
+     * opponent, it is below 100 (or -1000 if we have to pass), which proves fail-lows. The side whose
+     * bound is more useful for where the score lies is generated first.
+     */
+    bool playerFirst = others >= ((double) alpha + beta) / 2;
+    uint64_t pMovesPossible = 0, oMovesPossible = 0;
+    if(playerFirst) {
+        pMovesPossible = this->generateMoveMask(pBoard.getBits(), oBoard.getBits());
+        if(stats != nullptr && pMovesPossible != 0 && outside(-100, 1000, stats->lazyMobilityExits, bound)) {
+            return bound;
+        }
+        // Without a move of our own, mobility is -1000 whatever the opponent can do.
+        if(pMovesPossible != 0) {
+            oMovesPossible = this->generateMoveMask(oBoard.getBits(), pBoard.getBits());
+        }
+    } else {
+        oMovesPossible = this->generateMoveMask(oBoard.getBits(), pBoard.getBits());
+        if(stats != nullptr && oMovesPossible != 0 && outside(-1000, 100, stats->lazyMobilityExits, bound)) {
+            return bound;
+        }
+        pMovesPossible = this->generateMoveMask(pBoard.getBits(), oBoard.getBits());
     }
 
-    wStability = getSumWeight(pPosWeight, oPosWeight);
-    wParity = getSumWeight(pCount, oCount);
-    wCorners = getSumWeight(pCorners, oCorners);
-    wAdjCorners = -getSumWeight(pAdjCorners, oAdjCorners);
     wMobility = getSumWeight(countBits(pMovesPossible), countBits(oMovesPossible));
 
     // Apply high weight to forcing passes.
@@ -362,84 +565,324 @@ int OthelloGameBoard::evaluate() {
     int score = (int) (fCorners * wCorners) + (fAdjacent * wAdjCorners) + (fMobility * wMobility) +
                 (fParity * wParity) + (fStability * wStability);
 
-    if(pAdjCorners == 1) {
-//        printf("Foo\n");
-    }
+    return score;
+}
 
-    // End game. Return below for confirmed win / loss.
-    if(sumMoves == 64) {
-        if(pCount < oCount) {
-            return -1000000 * (oCount - pCount);
-        } else {
-            return 1000000 * (pCount - oCount);
-        }
-    } else {
-        return score;
+template<OthelloGameBoard::NodeType Type, bool Max, OthelloGameBoard::SearchPhase Phase>
+BITS_DISPATCH std::pair<int, int> OthelloGameBoard::alphaBeta(OthelloGameBoard &gameBoard, int player, int depth, int maxDepth,
+                                                SearchContext &ctx, int alpha, int beta) {
+    constexpr bool pvNode = Type == NodeType::Pv;
+    constexpr bool endgame = Phase == SearchPhase::Endgame;
+
+    // Aborted: unwind right away. The caller discards whatever is returned.
+    if(ctx.shouldStop()) {
+        return { 0, depth };
     }
-}
 
-std::pair<int, int> OthelloGameBoard::alphaBeta(OthelloGameBoard gameBoard, int player, int depth, int maxDepth,
-                                 uint64_t stopTime, int alpha, int beta, bool max) {
-    if(this->getCurrentSysTime() > stopTime || depth >= maxDepth || gameBoard.isGameComplete()) {
-        return { gameBoard.evaluate(), depth };
+    ctx.clearPv(depth);
+
+    const SearchParams &params = ctx.getParams();
+    SearchStats &stats = ctx.getStats();
+    // Leaves outside the window only need to be scored well enough to prove that.
+    SearchStats *lazyStats = params.lazyEval ? &stats : nullptr;
+
+    // Scores here are from m_playerColor's point of view whoever is to move, table scores from the side
+    // to move's, so that searches for both colors share the table. They are converted on the way in and out.
+    // The player maximizes, so a max node is one where the player is to move.
+    assert(Max == (player == m_playerColor));
+    uint64_t key = gameBoard.getKey(player);
+    int draft = maxDepth - depth;
+    int alphaOrig = alpha;
+    int betaOrig = beta;
+
+    // Opt-in: the top of the tree is written to a TreeRecorder as each node finishes.
+    TreeRecorder *recorder = ctx.getRecorder();
+    bool recording = recorder != nullptr && recorder->shouldRecord(depth);
+    TreeRecord record;
+    uint64_t nodesBefore = ctx.getNodes();
+    if(recording) {
+        record.key = key;
+        record.ply = (uint8_t) depth;
+        record.draft = (uint8_t) std::max(0, draft);
+        record.empties = (uint8_t) (64 - countBits(gameBoard.getPlayer().getBits() | gameBoard.getOpponent().getBits()));
+        record.iteration = (uint8_t) maxDepth;
+        record.flags = recorder->takeNextFlags();
+    }
+    auto finish = [&](int score, uint8_t flags) -> std::pair<int, int> {
+        if(recording) {
+            record.flags |= flags;
+            recordNode(recorder, record, alphaOrig, betaOrig, score, Max, ctx.getNodes() - nodesBefore + 1);
+        }
+        return { score, depth };
+    };
+
+    // In the endgame the depth limit lies beyond the end of the game, so every line ends in a pass
+    // or a full board first.
+    if constexpr(!endgame) {
+        if(depth >= maxDepth) {
+            return finish(gameBoard.evaluate(alpha, beta, lazyStats), TREE_FLAG_LEAF);
+        }
     }
 
     BitBoard pBoard = gameBoard.getForColor(player);
     BitBoard oBoard = gameBoard.getForColor(-player);
 
-    auto moves = this->generateMovesAsPriorityQueue(pBoard, oBoard);
+    // Without a move the side to move passes, and the opponent moves on at the same remaining depth.
+    // If the opponent cannot move either, the game is over and scored by the final disc count.
+    uint64_t moveMask = this->generateMoveMask(pBoard.getBits(), oBoard.getBits());
+    if(moveMask == 0) {
+        if(this->generateMoveMask(oBoard.getBits(), pBoard.getBits()) == 0) {
+            int discs = countBits(pBoard.getBits()) - countBits(oBoard.getBits());
+            return finish(1000000 * (Max ? discs : -discs), TREE_FLAG_LEAF);
+        }
 
-    if(max) {
-        if(moves.empty()) {
-            return { gameBoard.evaluate(), depth };
+        // The principal variation ends at the pass, which is not a move.
+        std::pair<int, int> eval = alphaBeta<Type, !Max, Phase>(gameBoard, -player, depth + 1, maxDepth + 1, ctx,
+                                                                alpha, beta);
+        if(ctx.isAborted()) {
+            return { 0, depth };
         }
+        return finish(eval.first, TREE_FLAG_PASS);
+    }
 
-        int maxEval = INT32_MIN;
-        while(!moves.empty()) {
-            auto newMaximizerBoard = BitBoard(pBoard);
-            auto newBoard = OthelloGameBoard(gameBoard);
-            newBoard.applyMove(newMaximizerBoard, moves.top());
-            moves.pop();
+    TranspositionTable *tt = ctx.getTable();
+    int ttMove = -1;
+
+    if(tt != nullptr) {
+        TTEntry entry;
+        if(tt->probe(key, entry)) {
+            toPlayerView(entry, Max);
+            if(entry.draft >= draft && (entry.bound == TTBound::Exact ||
+                                        (entry.bound == TTBound::Lower && entry.score >= beta) ||
+                                        (entry.bound == TTBound::Upper && entry.score <= alpha))) {
+                stats.ttCutoffs++;
+                return finish(entry.score, TREE_FLAG_TT_CUTOFF);
+            }
+            if(entry.move != TT_NO_MOVE && ((1ULL << entry.move) & moveMask) != 0) {
+                ttMove = entry.move;
+            }
+        }
+    }
 
-            auto eval = alphaBeta(newBoard, -player, depth + 1, maxDepth, stopTime, alpha, beta, false);
-            maxEval = std::max(maxEval, eval.first);
-            alpha = std::max(alpha, eval.first);
-            if(beta <= alpha) {
-                break;
+    // Enhanced transposition cutoffs: a child that is already known to refute the window ends the
+    // node before anything is searched. At a max node that is a child scoring at least beta, at a
+    // min node one scoring at most alpha.
+    if(tt != nullptr && params.etc && draft >= params.etcMinDraft) {
+        stats.etcProbes++;
+        // The children's keys are relative to the other side, whose key of this position is the other one.
+        uint64_t otherKey = gameBoard.getKey(-player);
+        uint64_t moves = moveMask;
+        for(; moves != 0; moves = Bits::clearLowest(moves)) {
+            int pos = Bits::lowest(moves);
+            uint64_t flips = getFlips(pBoard.getBits(), oBoard.getBits(), pos);
+            uint64_t childKey = otherKey ^ Zobrist::moveDelta(1, pos, flips);
+
+            TTEntry entry;
+            if(!tt->probe(childKey, entry) || entry.draft < draft - 1) {
+                continue;
+            }
+            toPlayerView(entry, !Max);
+
+            bool refutes = Max ? entry.bound != TTBound::Upper && entry.score >= beta
+                               : entry.bound != TTBound::Lower && entry.score <= alpha;
+            if(refutes) {
+                stats.etcCutoffs++;
+                storeForMover(tt, key, entry.score, pos, draft, Max ? TTBound::Lower : TTBound::Upper, Max);
+                record.bestMove = (uint8_t) pos;
+                return finish(entry.score, TREE_FLAG_ETC_CUTOFF);
+            }
+        }
+    }
+
+    // Reductions would make a search to the end of the game inexact, so there are none in the endgame.
+    // In the midgame the depth limit always comes before the end.
+    assert(endgame || draft < 64 - countBits(pBoard.getBits() | oBoard.getBits()));
+    bool reduce = !endgame && params.lmr && draft >= params.lmrMinDraft;
+    int reduction = std::min(params.lmrReduction, draft - 1);
+    int moveIndex = 0;
+
+    int moves[64];
+    int moveCount = orderMoves(moveMask, moves);
+    int nextMove = 0;
+
+    // While still on the previous iteration's principal variation, its move is searched first.
+    // Otherwise the best move stored for this position is. Null-window searches are never on it.
+    int pvMove = pvNode ? ctx.getPvMove(depth, moveMask) : -1;
+    bool followingPv = pvMove >= 0;
+    int firstMove = followingPv ? pvMove : ttMove;
+    int searchedFirstMove = -1;
+    int bestMove = -1;
+    // Children are recorded too, with how they were searched.
+    bool recordChildren = recording && recorder->shouldRecord(depth + 1);
+    if(recording) {
+        record.moveCount = (uint8_t) moveCount;
+        record.flags |= followingPv ? TREE_FLAG_PV_MOVE : ttMove >= 0 ? TREE_FLAG_TT_MOVE : 0;
+    }
+
+    int bestEval = Max ? INT32_MIN : INT32_MAX;
+    while(firstMove >= 0 || nextMove < moveCount) {
+        Move move;
+        if(firstMove >= 0) {
+            move = Move(firstMove, 0);
+        } else {
+            move = Move(moves[nextMove++], 0);
+
+            if(move.getPos() == searchedFirstMove) {
+                continue;
             }
         }
-        return { maxEval, depth };
-    } else {
 
-        if(moves.empty()) {
-            return { gameBoard.evaluate(), depth };
+        auto newPBoard = BitBoard(pBoard);
+        auto newBoard = OthelloGameBoard(gameBoard);
+        newBoard.applyMove(newPBoard, move);
+
+        // Only the first move of a PV node is searched with the full window. Every other move just has
+        // to prove it is no better than the best so far, with a null window at the bound the side to
+        // move has to beat, and is searched again with the full window if it turns out better.
+        bool fullWindow = pvNode && moveIndex == 0;
+        int nullAlpha = Max ? alpha : beta - 1;
+        int nullBeta = Max ? alpha + 1 : beta;
+        auto beatsBound = [&](int score) {
+            return Max ? score > alpha : score < beta;
+        };
+
+        // Late, poorly ordered moves are searched shallower first, and again at full depth only if
+        // they beat the best move so far.
+        std::pair<int, int> eval;
+        bool reduced = false;
+        if constexpr(!endgame) {
+            reduced = reduce && reduction > 0 && moveIndex >= params.lmrMinMoves;
+            if(reduced) {
+                stats.lmrReductions++;
+                if(recordChildren) {
+                    recorder->setNextFlags(TREE_FLAG_REDUCED);
+                }
+                eval = alphaBeta<NodeType::NonPv, !Max, Phase>(newBoard, -player, depth + 1, maxDepth - reduction,
+                                                               ctx, nullAlpha, nullBeta);
+                if(!ctx.isAborted() && beatsBound(eval.first)) {
+                    stats.lmrResearches++;
+                    reduced = false;
+                    if(recordChildren) {
+                        recorder->setNextFlags(TREE_FLAG_RESEARCH);
+                    }
+                }
+            }
+        }
+        if(!reduced && fullWindow) {
+            eval = alphaBeta<NodeType::Pv, !Max, Phase>(newBoard, -player, depth + 1, maxDepth, ctx, alpha, beta);
+        } else if(!reduced) {
+            eval = alphaBeta<NodeType::NonPv, !Max, Phase>(newBoard, -player, depth + 1, maxDepth, ctx, nullAlpha,
+                                                           nullBeta);
+            if constexpr(pvNode) {
+                if(!ctx.isAborted() && beatsBound(eval.first) && (Max ? eval.first < beta : eval.first > alpha)) {
+                    if(recordChildren) {
+                        recorder->setNextFlags(TREE_FLAG_RESEARCH);
+                    }
+                    eval = alphaBeta<NodeType::Pv, !Max, Phase>(newBoard, -player, depth + 1, maxDepth, ctx, alpha, beta);
+                }
+            }
         }
+        moveIndex++;
 
-        int minEval = INT32_MAX;
-        while(!moves.empty()) {
-            auto newPBoard = BitBoard(pBoard);
-            auto newBoard = OthelloGameBoard(gameBoard);
+        if(firstMove >= 0) {
+            if(followingPv) {
+                ctx.leavePv();
+            }
+            searchedFirstMove = firstMove;
+            firstMove = -1;
+        }
 
-            newBoard.applyMove(newPBoard, moves.top());
-            moves.pop();
+        if(ctx.isAborted()) {
+            return { 0, depth };
+        }
 
-            auto eval = alphaBeta(newBoard, -player, depth + 1, maxDepth, stopTime, alpha, beta, true);
-            minEval = std::min(minEval, eval.first);
+        if(Max ? eval.first > bestEval : eval.first < bestEval) {
+            bestEval = eval.first;
+            bestMove = move.getPos();
+            record.bestIndex = (uint8_t) (moveIndex - 1);
+            if constexpr(pvNode) {
+                ctx.updatePv(depth, move.getPos());
+            }
+        }
+
+        if constexpr(Max) {
+            alpha = std::max(alpha, eval.first);
+        } else {
             beta = std::min(beta, eval.first);
-            if(beta <= alpha) {
+        }
+
+        if(beta <= alpha) {
+            break;
+        }
+    }
+
+    if(tt != nullptr) {
+        TTBound bound = bestEval <= alphaOrig ? TTBound::Upper : bestEval >= betaOrig ? TTBound::Lower : TTBound::Exact;
+        storeForMover(tt, key, bestEval, bestMove, draft, bound, Max);
+    }
+
+    record.bestMove = (uint8_t) bestMove;
+    return finish(bestEval, 0);
+}
+
+BITS_DISPATCH std::pair<int, int> OthelloGameBoard::searchRootChild(OthelloGameBoard &gameBoard, int player, int maxDepth,
+                                                      SearchContext &ctx, int alpha, int beta, bool pv, bool endgame) {
+    bool max = player == m_playerColor;
+    if(endgame) {
+        if(pv) {
+            return max ? alphaBeta<NodeType::Pv, true, SearchPhase::Endgame>(gameBoard, player, 1, maxDepth, ctx, alpha, beta)
+                       : alphaBeta<NodeType::Pv, false, SearchPhase::Endgame>(gameBoard, player, 1, maxDepth, ctx, alpha, beta);
+        }
+        return max ? alphaBeta<NodeType::NonPv, true, SearchPhase::Endgame>(gameBoard, player, 1, maxDepth, ctx, alpha, beta)
+                   : alphaBeta<NodeType::NonPv, false, SearchPhase::Endgame>(gameBoard, player, 1, maxDepth, ctx, alpha, beta);
+    }
+    if(pv) {
+        return max ? alphaBeta<NodeType::Pv, true, SearchPhase::Midgame>(gameBoard, player, 1, maxDepth, ctx, alpha, beta)
+                   : alphaBeta<NodeType::Pv, false, SearchPhase::Midgame>(gameBoard, player, 1, maxDepth, ctx, alpha, beta);
+    }
+    return max ? alphaBeta<NodeType::NonPv, true, SearchPhase::Midgame>(gameBoard, player, 1, maxDepth, ctx, alpha, beta)
+               : alphaBeta<NodeType::NonPv, false, SearchPhase::Midgame>(gameBoard, player, 1, maxDepth, ctx, alpha, beta);
+}
+
+int OthelloGameBoard::extendLine(const TranspositionTable *tt, int color, int *line, int length, int maxLength) {
+    if(tt == nullptr) {
+        return length;
+    }
+
+    // Replay the line, then follow the stored best moves. Lines cut short by transposition cutoffs
+    // continue where the entry that caused the cutoff was searched.
+    uint64_t player = this->getPlayer().getBits();
+    uint64_t opponent = this->getOpponent().getBits();
+    for(int i = 0; i < maxLength; i++) {
+        bool byPlayer = color == m_playerColor;
+        uint64_t &own = byPlayer ? player : opponent;
+        uint64_t &other = byPlayer ? opponent : player;
+
+        if(i >= length) {
+            TTEntry entry;
+            uint64_t key = Zobrist::compute(own, other);
+            if(!tt->probe(key, entry) || entry.move == TT_NO_MOVE ||
+               ((1ULL << entry.move) & generateMoveMask(own, other)) == 0) {
                 break;
             }
+            line[length++] = entry.move;
         }
-        return { minEval, depth };
+
+        uint64_t flips = getFlips(own, other, line[i]);
+        own |= flips | (1ULL << line[i]);
+        other &= ~flips;
+        color = -color;
     }
+
+    return length;
 }
 
 // TODO: Convert random param to sep function 'getRandomMove()'
 Move OthelloGameBoard::selectMove(int playerColor, bool random) {
     BitBoard primary = this->getForColor(playerColor);
     BitBoard opponent = this->getForColor(-playerColor);
+    this->m_lastSearch = SearchInfo();
 
-    // Moves generated, but only for the sake of counting them. Moves are generated again inside alphaBeta.
     auto possibleMoves = this->generateMovesAsPriorityQueue(primary, opponent);
 
     if(possibleMoves.empty()) {
@@ -450,84 +893,348 @@ Move OthelloGameBoard::selectMove(int playerColor, bool random) {
         return possibleMoves.top();
     }
 
-    // Calculates the time to iteratively search 1 move out of the child list.
-    // This way, all children are given equal search time.
-    int staticTime = (int) ((this->getCfg().getMoveTime() / (double) possibleMoves.size()) * 1000);
+    SearchContext ctx;
+    ctx.setParams(this->getCfg().getSearchParams());
+    return this->selectMove(playerColor, SearchLimits(), ctx);
+}
 
-    Logger::logComment("Allowing " + std::to_string(staticTime) + "ms for next evaluations.");
+Move OthelloGameBoard::selectMove(int playerColor, const SearchLimits &limits, SearchContext &ctx) {
+    TRACE_SCOPE("selectMove");
+    ALLOC_PHASE(AllocPhase::Setup);
+    BitBoard primary = this->getForColor(playerColor);
+    BitBoard opponent = this->getForColor(-playerColor);
+    this->m_lastSearch = SearchInfo();
 
-    Move bestMove = possibleMoves.top();
-    uint64_t size = possibleMoves.size();
-    int totalBits = primary.getCellCount() + opponent.getCellCount();
+    auto possibleMoves = this->generateMovesAsPriorityQueue(primary, opponent);
 
-    int depthReached;
-    int counter = 1;
+    if(possibleMoves.empty()) {
+        return Move();
+    }
 
-    while(!possibleMoves.empty()) {
-        uint64_t execTime = this->getCurrentSysTime();
-        uint64_t endTime = execTime + staticTime;
+    PerfSample perfBefore = PerfCounters::read();
+    TreeRecorder *recorder = ctx.getRecorder();
+    if(recorder != nullptr) {
+        recorder->beginSearch();
+    }
 
-        Move cur = possibleMoves.top();
+    // One iterative deepening loop over all root moves shares the whole move budget. The watchdog
+    // enforces the budget plus a grace period as a hard deadline in case an iteration overruns.
+    // Without a time limit, only depth, nodes or a stop end the search.
+    int64_t budgetMs = -1;
+    if(limits.useConfigTime()) {
+        budgetMs = (int64_t) (this->getCfg().getMoveTime() * 1000);
+    } else if(limits.moveTimeMs > 0) {
+        budgetMs = limits.moveTimeMs;
+    }
+
+    std::unique_ptr<Watchdog> watchdog;
+    if(budgetMs >= 0) {
+        Logger::logComment("Allowing " + std::to_string(budgetMs) + "ms for this move.");
+
+        ctx.setDeadline(SearchContext::now() + std::chrono::milliseconds(budgetMs));
+        watchdog = std::make_unique<Watchdog>(ctx, SearchContext::now() +
+                std::chrono::milliseconds(budgetMs + budgetMs / HARD_DEADLINE_GRACE_DIV));
+    }
+    if(limits.nodes != 0) {
+        ctx.setNodeLimit(limits.nodes);
+    }
+    if(ctx.getTable() != nullptr) {
+        ctx.getTable()->newSearch();
+    }
+
+    // evaluate() always scores from m_playerColor's point of view. When searching for the other
+    // color the scores are negated, so that the root always maximizes.
+    bool rootIsPlayer = playerColor == this->m_playerColor;
+    int sign = rootIsPlayer ? 1 : -1;
+
+    struct RootMove {
+        Move move;
+        int score;
+        uint64_t nodes;
+        int pv[MAX_SEARCH_PLY];
+        int pvLength;
+    };
+
+    std::vector<RootMove> rootMoves;
+    while(!possibleMoves.empty()) {
+        rootMoves.push_back({ possibleMoves.top(), INT32_MIN, 0, {}, 0 });
         possibleMoves.pop();
+    }
 
-        int prevVal;
-        std::pair<int, int> eval;
+    // Multi-PV: the best multiPv moves get exact scores. They share one window, whose lower bound
+    // is the multiPv-th best score so far, so any other move only has to be refuted against that.
+    size_t multiPv = (size_t) std::max(1, std::min(limits.multiPv, (int) rootMoves.size()));
+    std::vector<int> topScores;
+    topScores.reserve(multiPv + 1);
+    ctx.clearLines();
+
+    int empties = 64 - (primary.getCellCount() + opponent.getCellCount());
+
+    // Only moves from fully completed iterations ever make it into bestMove.
+    Move bestMove = rootMoves[0].move;
+    int bestDepth = 0;
+    int stableIterations = 0;
+
+    // Depth grows in steps of depthStep from depthStart, capped at the depth limit if there is one.
+    const SearchParams &params = ctx.getParams();
+    auto nextDepth = [&](int depth) {
+        int next = depth == 0 ? params.depthStart : depth + params.depthStep;
+        return limits.depth > 0 ? std::min(next, limits.depth) : next;
+    };
+
+    // Near the end, part of the move time goes to proving the outcome. A proven win or draw is
+    // played right away; a loss, or no proof in time, leaves the choice to the usual search.
+    bool proven = false;
+    DfpnSolver *solver = ctx.getSolver();
+    if(solver != nullptr && budgetMs > 0 && empties <= params.dfpnEmpties && rootMoves.size() > 1 &&
+       multiPv == 1) {
+        DfpnResult proof = solver->solve(primary.getBits(), opponent.getBits(), SearchContext::now() +
+                                         std::chrono::milliseconds(budgetMs * params.dfpnTimeShare / 100), ctx);
+        Logger::logComment("Proof-number search: " + std::string(DfpnSolver::getOutcomeName(proof.outcome)) + ", " +
+                           std::to_string(proof.nodes) + " nodes, " + std::to_string(proof.timeMs) + "ms");
+
+        for(RootMove &rootMove : rootMoves) {
+            if(rootMove.move.getPos() == proof.move) {
+                // Only the outcome is known, so the score is that of the smallest win.
+                proven = true;
+                bestMove = rootMove.move;
+                bestMove.setValue(proof.outcome == DfpnOutcome::Win ? 1000000 : 0);
+                bestDepth = empties;
+
+                ALLOC_PHASE(AllocPhase::Report);
+                ctx.clearLines();
+                ctx.addLine(proof.move, bestMove.getValue(), &proof.move, 1);
+                SearchInfo info;
+                info.score = bestMove.getValue();
+                info.depth = empties;
+                info.nodes = ctx.getNodes();
+                info.timeMs = ctx.getElapsedMs();
+                ctx.reportIteration(info, &proof.move, 1);
+            }
+        }
+    }
+
+    for(int maxDepth = nextDepth(0); !proven; maxDepth = nextDepth(maxDepth)) {
+        // Iterations that reach the end of the game are the exact endgame solve.
+        TRACE_SCOPE_ARG(maxDepth >= empties ? "endgame solve" : "iteration", "depth", maxDepth);
+        int alpha = INT32_MIN;
+        int bestScore = INT32_MIN;
+        int iterationBest = 0;
+        uint64_t iterationNodes = ctx.getNodes();
+        topScores.clear();
+
+        for(size_t i = 0; i < rootMoves.size(); i++) {
+            RootMove &rootMove = rootMoves[i];
 
-        // Iterative deepening while time allows. We start at depth 6.
-        for(int maxDepth = 2; this->getCurrentSysTime() < endTime && maxDepth < (64 - totalBits); maxDepth += 2) {
             auto newPrimary = BitBoard(primary);
             auto newBoard = OthelloGameBoard(*this);
-            newBoard.applyMove(newPrimary, cur);
+            newBoard.applyMove(newPrimary, rootMove.move);
+
+            if(i == 0 && ctx.getSeedMove() == rootMove.move.getPos()) {
+                ctx.beginPvFollow();
+            }
+
+            // The window is (alpha, inf) in root terms, mapped into m_playerColor's terms. Once there
+            // is an alpha, a move is first only tested against it with a null window (alpha, alpha + 1),
+            // and searched with the full window only if it beats alpha.
+            auto searchRoot = [&](int high) {
+                ALLOC_PHASE(AllocPhase::Tree);
+                int childAlpha = rootIsPlayer ? alpha : (high == INT32_MAX ? INT32_MIN : -high);
+                int childBeta = rootIsPlayer ? high : (alpha == INT32_MIN ? INT32_MAX : -alpha);
+                return this->searchRootChild(newBoard, -playerColor, maxDepth, ctx, childAlpha, childBeta,
+                                             high == INT32_MAX, maxDepth >= empties);
+            };
+
+            uint64_t nodesBefore = ctx.getNodes();
+            std::pair<int, int> eval;
+            if(alpha != INT32_MIN) {
+                eval = searchRoot(alpha + 1);
+                if(!ctx.isAborted() && sign * eval.first > alpha) {
+                    if(recorder != nullptr && recorder->shouldRecord(1)) {
+                        recorder->setNextFlags(TREE_FLAG_RESEARCH);
+                    }
+                    eval = searchRoot(INT32_MAX);
+                }
+            } else {
+                eval = searchRoot(INT32_MAX);
+            }
+            ctx.leavePv();
+
+            if(ctx.isAborted()) {
+                break;
+            }
+
+            rootMove.nodes = ctx.getNodes() - nodesBefore;
+            rootMove.score = sign * eval.first;
+            rootMove.pvLength = ctx.copyRootLine(rootMove.move.getPos(), rootMove.pv);
+            rootMove.pvLength = this->extendLine(ctx.getTable(), playerColor, rootMove.pv, rootMove.pvLength,
+                                                 std::min(maxDepth, MAX_SEARCH_PLY));
+
+            if(rootMove.score > bestScore) {
+                bestScore = rootMove.score;
+                iterationBest = (int) i;
+                ctx.updatePv(0, rootMove.move.getPos());
+            }
+
+            if(rootMove.score > alpha) {
+                topScores.insert(std::upper_bound(topScores.begin(), topScores.end(), rootMove.score,
+                                                  std::greater<int>()), rootMove.score);
+                if(topScores.size() > multiPv) {
+                    topScores.pop_back();
+                }
+                if(topScores.size() == multiPv) {
+                    alpha = topScores.back();
+                }
+            }
+        }
+
+        // A partial iteration is thrown away entirely.
+        if(ctx.isAborted()) {
+            break;
+        }
+
+        if(recorder != nullptr && recorder->shouldRecord(0)) {
+            TreeRecord root;
+            root.key = this->getKey(playerColor);
+            root.alpha = INT32_MIN;
+            root.beta = INT32_MAX;
+            root.score = bestScore;
+            root.nodes = (uint32_t) std::min<uint64_t>(ctx.getNodes() - iterationNodes, UINT32_MAX);
+            root.draft = (uint8_t) maxDepth;
+            root.empties = (uint8_t) empties;
+            root.moveCount = (uint8_t) rootMoves.size();
+            root.bestIndex = (uint8_t) iterationBest;
+            root.bestMove = (uint8_t) rootMoves[iterationBest].move.getPos();
+            root.iteration = (uint8_t) maxDepth;
+            recorder->add(root);
+        }
 
-            eval = this->alphaBeta(newBoard, -playerColor, 1, maxDepth, endTime, INT32_MIN, INT32_MAX, true);
-            cur.setValue(eval.first);
-            if(maxDepth > 2) {
-                prevVal = cur.getValue();
+        // Next iteration: best moves first, then the moves whose subtrees were hardest to refute.
+        // Scores of the other moves are only upper bounds, so subtree size is the better guide.
+        std::swap(rootMoves[0], rootMoves[iterationBest]);
+        std::stable_sort(rootMoves.begin() + 1, rootMoves.end(), [](const RootMove &a, const RootMove &b) {
+            return a.score > b.score;
+        });
+        std::stable_sort(rootMoves.begin() + (long) multiPv, rootMoves.end(), [](const RootMove &a, const RootMove &b) {
+            return a.nodes > b.nodes;
+        });
+        ctx.seedPv();
+
+        stableIterations = rootMoves[0].move.getPos() == bestMove.getPos() ? stableIterations + 1 : 0;
+        bestMove = rootMoves[0].move;
+        bestMove.setValue(rootMoves[0].score);
+        bestDepth = maxDepth;
+
+        ALLOC_PHASE(AllocPhase::Report);
+        ctx.clearLines();
+        for(size_t line = 0; line < multiPv; line++) {
+            const RootMove &rootMove = rootMoves[line];
+            ctx.addLine(rootMove.move.getPos(), rootMove.score, rootMove.pv, rootMove.pvLength);
+
+            SearchInfo iteration;
+            iteration.score = rootMove.score;
+            iteration.depth = maxDepth;
+            iteration.nodes = ctx.getNodes();
+            iteration.timeMs = ctx.getElapsedMs();
+            iteration.line = (int) line + 1;
+            ctx.reportIteration(iteration, rootMove.pv, rootMove.pvLength);
+
+            std::string pv;
+            for(int i = 0; i < rootMove.pvLength; i++) {
+                pv += OutputHandler::getMoveOutput(i % 2 == 0 ? playerColor : -playerColor, Move(rootMove.pv[i], 0), false) + " ";
             }
+            Logger::logComment("Depth " + std::to_string(maxDepth) +
+                               (multiPv > 1 ? " line " + std::to_string(line + 1) : "") + ": score " +
+                               std::to_string(rootMove.score) + ", " + std::to_string(ctx.getNodes()) + " nodes, " +
+                               std::to_string(ctx.getElapsedMs()) + "ms, pv " + pv);
+        }
 
-            depthReached = maxDepth;
+        // Exact result, or nothing to choose from.
+        if(maxDepth >= empties || rootMoves.size() == 1) {
+            break;
         }
 
-        std::string curMoveReadable = OutputHandler::getMoveOutput(primary.getColor(), cur, false);
-        char *cstr = new char[curMoveReadable.length() + 1];
-        strcpy(cstr, curMoveReadable.c_str());
+        if(limits.depth > 0 && maxDepth >= limits.depth) {
+            break;
+        }
 
-        // The previous value is used because the 'cur' variable's value is invalid at this point due to time interrupt.
-        if(prevVal > bestMove.getValue()) {
-            bestMove = cur;
+        // The remaining checks manage the time budget.
+        if(budgetMs < 0) {
+            continue;
         }
 
-        printf("C Evaluated move [%s] (%d / %llu) to depth %d with score %d\n", cstr, counter, size, depthReached, prevVal);
-        free(cstr);
-        counter++;
+        // Easy move: the same move has stayed best by a wide margin for several iterations. The other
+        // moves are ordered by subtree size, so the runner-up is whichever scores highest; its score is
+        // an upper bound, which keeps the margin safe.
+        int runnerUp = INT32_MIN;
+        for(size_t i = 1; i < rootMoves.size(); i++) {
+            runnerUp = std::max(runnerUp, rootMoves[i].score);
+        }
+        if(stableIterations >= EASY_MOVE_STABLE_ITERATIONS &&
+           (int64_t) rootMoves[0].score - runnerUp >= EASY_MOVE_MARGIN) {
+            Logger::logComment("Easy move, stopping early");
+            break;
+        }
+
+        // The next iteration costs several times the previous ones, so it would not finish anyway.
+        if((int64_t) ctx.getElapsedMs() * NEXT_ITERATION_TIME_DIV > budgetMs) {
+            break;
+        }
     }
 
-    std::string bestMoveReadable = OutputHandler::getMoveOutput(primary.getColor(), bestMove, false);
-    char *cstr = new char[bestMoveReadable.length() + 1];
-    strcpy(cstr, bestMoveReadable.c_str());
+    if(bestDepth == 0) {
+        Logger::log(LogLevel::Warn, "No iteration completed, falling back to move ordering");
+    }
+    if(watchdog && watchdog->hasFired()) {
+        Logger::log(LogLevel::Warn, "Hard deadline reached, search stopped by watchdog");
+    }
+
+    ALLOC_PHASE(AllocPhase::Report);
+    Logger::logComment("Identified move [" + OutputHandler::getMoveOutput(primary.getColor(), bestMove, false) +
+                       "] as best move with score " + std::to_string(bestMove.getValue()));
 
-    printf("C Identified move [%s] as best move with score %d\n", cstr, bestMove.getValue());
-    free(cstr);
+    [[maybe_unused]] const SearchStats &stats = ctx.getStats();
+    LOG_DEBUG("TT cutoffs " + std::to_string(stats.ttCutoffs) + ", ETC " + std::to_string(stats.etcCutoffs) + "/" +
+              std::to_string(stats.etcProbes) + ", LMR re-searches " + std::to_string(stats.lmrResearches) + "/" +
+              std::to_string(stats.lmrReductions) + ", lazy eval exits " + std::to_string(stats.lazyCheapExits) +
+              "+" + std::to_string(stats.lazyMobilityExits) + "/" + std::to_string(stats.lazyEvals));
+
+    this->m_lastSearch.score = bestMove.getValue();
+    this->m_lastSearch.depth = bestDepth;
+    this->m_lastSearch.nodes = ctx.getNodes();
+    this->m_lastSearch.timeMs = ctx.getElapsedMs();
+
+    if(PerfCounters::isOpen()) {
+        Logger::logComment("Counters: " + PerfCounters::read().since(perfBefore).describe(ctx.getNodes()));
+    }
+    if(recorder != nullptr) {
+        recorder->endSearch();
+    }
 
     return bestMove;
 }
 
 std::priority_queue<Move, std::vector<Move>, std::less<std::vector<Move>::value_type>> OthelloGameBoard::getMovesAsPriorityQueue(uint64_t state) {
     std::priority_queue<Move, std::vector<Move>, std::less<std::vector<Move>::value_type>> pQueue;
-    for (int i = 0; i < 64; i++) {
-        uint64_t mask = 1LL << i;
-        if ((mask & state) != 0) {
-            int weight = WEIGHT_MAP[i];
-            pQueue.push(Move(i, weight));
-        }
-    }
+    Bits::forEach(state, [&](int pos) {
+        pQueue.push(Move(pos, WEIGHT_MAP[pos]));
+    });
 
     return pQueue;
 }
 
-uint64_t OthelloGameBoard::getCurrentSysTime() {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count();
+int OthelloGameBoard::orderMoves(uint64_t moveMask, int *moves) {
+    // Insertion sort: a position rarely has more than a dozen moves.
+    int count = 0;
+    Bits::forEach(moveMask, [&](int pos) {
+        int i = count++;
+        for(; i > 0 && WEIGHT_MAP[moves[i - 1]] < WEIGHT_MAP[pos]; i--) {
+            moves[i] = moves[i - 1];
+        }
+        moves[i] = pos;
+    });
+
+    return count;
 }
 
 BitBoard OthelloGameBoard::getForColor(int color) {
@@ -538,6 +1245,14 @@ int OthelloGameBoard::getPlayerColor() {
     return this->m_playerColor;
 }
 
+uint64_t OthelloGameBoard::getKey(int color) const {
+    return color == m_playerColor ? this->m_hash : this->m_opponentHash;
+}
+
+const SearchInfo &OthelloGameBoard::getLastSearchInfo() const {
+    return this->m_lastSearch;
+}
+
 void OthelloGameBoard::setForColor(BitBoard board) {
     auto playerBoard = this->getPlayer();
     if (board.getColor() == playerBoard.getColor()) {
@@ -5,7 +5,6 @@
 #ifndef OTHELLOPROJECT_CPP_OTHELLOGAMEBOARD_H
 #define OTHELLOPROJECT_CPP_OTHELLOGAMEBOARD_H
 
-#include <bitset>
 #include <chrono>
 #include <math.h>
 #include <map>
@@ -15,10 +14,17 @@
 
 #include "BitBoard.h"
 #include "Color.h"
+#include "EvalTerms.h"
 #include "Move.h"
+#include "SearchInfo.h"
+#include "../Bits.h"
 #include "../Config.h"
+#include "../Eval/Nnue.h"
 #include "../Utils.h"
 #include "../IO/Output/OutputHandler.h"
+#include "../Search/SearchContext.h"
+#include "../Search/SearchLimits.h"
+#include "../Search/TranspositionTable.h"
 
 /**
  * Represents the entire gameboard for both black and white. When working
@@ -48,7 +54,15 @@ public:
      * @param oppDisks Opponent's pieces
      * @return A uint64_t containing all possible moves for the color.
      */
-    uint64_t generateMoveMask(uint64_t playerDisks, uint64_t oppDisks);
+    static uint64_t generateMoveMask(uint64_t playerDisks, uint64_t oppDisks);
+    /**
+     * Computes the opponent disks that are flipped when the player places a disk at pos.
+     * @param playerDisks Player's pieces
+     * @param oppDisks Opponent's pieces
+     * @param pos The position being moved to, ranging 0-63 inclusive.
+     * @return Mask of the opponent disks that change color. Zero if the move captures nothing.
+     */
+    static uint64_t getFlips(uint64_t playerDisks, uint64_t oppDisks, int pos);
     /**
      * Selects a move for the given player. Calls alphaBeta if not random.
      * @param playerColor The color of the player the move is being selected for.
@@ -56,6 +70,12 @@ public:
      * @return An optimal move, using alphaBeta and alpha-beta pruning.
      */
     Move selectMove(int playerColor, bool random);
+    /**
+     * Selects a move for the given player by iterative deepening, within the given limits.
+     * @param ctx Search state. The caller resets it, and may stop() it from another thread.
+     * @return The best move of the last completed iteration, or a pass if there are no legal moves.
+     */
+    Move selectMove(int playerColor, const SearchLimits &limits, SearchContext &ctx);
     /**
      * Applies a move to the game board for the given color.
      * @param board The board to apply the move to.
@@ -85,6 +105,10 @@ public:
     void setForColor(BitBoard board);
     int getPlayerColor();
     const Config &getCfg() const;
+    /**
+     * @return Score, depth, node count and time of the most recent selectMove call.
+     */
+    const SearchInfo &getLastSearchInfo() const;
 
     /**
      * Returns true if the game is complete, false if the game is ongoing.
@@ -101,11 +125,37 @@ public:
      * @return Total amount of set bits in the provided data.
      */
     int countBits(uint64_t bits);
+    /**
+      * Scores the given board state. The higher the score, the better the board is for our player (AI).
+      * Uses the neural evaluator instead of the heuristic when a network is loaded.
+      * @return A score reflective of how much the board is in favor of our player.
+      */
+    int evaluate();
+    /**
+     * Lazy evaluate(): the score if it lies inside (alpha, beta), otherwise possibly only a bound
+     * outside the window that it is known not to cross, found without computing mobility.
+     * @param stats Counts the leaves and the early exits. Null to always compute the exact score.
+     */
+    int evaluate(int alpha, int beta, SearchStats *stats);
+    /**
+     * @return Zobrist key of the position with color to move (see Zobrist).
+     */
+    uint64_t getKey(int color) const;
 private:
     Config m_cfg;
     int m_playerColor;
     BitBoard m_playerBoard;
     BitBoard m_opponentBoard;
+    // First-layer state of the neural evaluator. Only maintained while a network is loaded.
+    NnueAccumulator m_acc;
+    // Incrementally maintained heuristic terms, see EvalTerms.
+    EvalTerms m_terms;
+    // Incrementally maintained Zobrist keys of the position with the player and with the opponent to move.
+    uint64_t m_hash;
+    uint64_t m_opponentHash;
+
+    // Only meaningful on the board selectMove is called on.
+    SearchInfo m_lastSearch;
 
     /**
      * Captures opponent pieces in a line, flipping all necessary opponent pieces along the way.
@@ -113,19 +163,82 @@ private:
      * @param newMove The most recent position selected on the board to move to.
      */
     void lineCap(BitBoard board, Move newMove);
+    /**
+     * Computes every EvalTerms field from scratch.
+     * @param player Bits of the player (AI).
+     * @param opponent Bits of the opponent.
+     */
+    static EvalTerms computeEvalTerms(uint64_t player, uint64_t opponent);
+    /**
+     * Adds (sign 1) or removes (sign -1) the corner-adjacent adjustments of every corner region
+     * that overlaps the touched squares.
+     */
+    static void addCornerRegions(EvalTerms &terms, uint64_t player, uint64_t opponent, uint64_t touched, int sign);
+    /**
+     * How a node is searched, so that alphaBeta is instantiated per kind. The first move of a PV node
+     * leads to a PV node, every other move to a non-PV one unless it has to be searched again.
+     */
+    enum class NodeType {
+        /**
+         * Open window: the node may lie on the principal variation, so it follows the previous
+         * iteration's and records its own.
+         */
+        Pv,
+        /**
+         * Null window, only proving a bound: there is no principal variation to follow or record,
+         * and every move below is searched with a null window as well.
+         */
+        NonPv
+    };
+    enum class SearchPhase {
+        /**
+         * The depth limit comes before the end of the game: leaves are scored at the limit, and late
+         * moves may be reduced.
+         */
+        Midgame,
+        /**
+         * The depth limit lies at or beyond the end of the game, so there is no depth check and no
+         * reduction, and the result is exact.
+         */
+        Endgame
+    };
     /**
      * Performs a minimax search with alpha-beta pruning.
+     * @tparam Max True where the player (AI) is to move and maximizes.
      * @param gameBoard The current state of the game.
-     * @param player The maximizing player.
+     * @param player The color to move.
      * @param depth The current search depth, starting from 1.
      * @param maxDepth The maximum depth to search to.
-     * @param stopTime The real system time at which to abort evaluation.
+     * @param ctx Node counter, deadline and stop flag for this search.
      * @param alpha The lowest value that max player will accept.
      * @param beta The highest value that min player will accept.
      * @return Pair with the score and depth of the evaluation (in that order).
+     * The score is meaningless if ctx.isAborted() is true once this returns.
+     */
+    template<NodeType Type, bool Max, SearchPhase Phase>
+    std::pair<int, int> alphaBeta(OthelloGameBoard &gameBoard, int player, int depth, int maxDepth,
+                                  SearchContext &ctx, int alpha, int beta);
+    /**
+     * Searches a child of the root with the alphaBeta instantiation for it.
+     * @param pv False for a null-window search.
+     * @param endgame True if maxDepth reaches the end of the game.
+     */
+    std::pair<int, int> searchRootChild(OthelloGameBoard &gameBoard, int player, int maxDepth, SearchContext &ctx,
+                                        int alpha, int beta, bool pv, bool endgame);
+    /**
+     * Extends a principal variation from this position with the best moves stored in the table.
+     * @param color The color making the first move of the line.
+     * @param line The line, with room for maxLength moves.
+     * @return The new length of the line.
      */
-    std::pair<int, int> alphaBeta(OthelloGameBoard gameBoard, int player, int depth, int maxDepth,
-                  uint64_t stopTime, int alpha, int beta, bool max);
+    int extendLine(const TranspositionTable *tt, int color, int *line, int length, int maxLength);
+    /**
+     * Writes the moves in moveMask into moves, highest WEIGHT_MAP value first, like
+     * getMovesAsPriorityQueue but without allocating. Used by the tree search.
+     * @param moves Room for 64 moves.
+     * @return The number of moves.
+     */
+    static int orderMoves(uint64_t moveMask, int *moves);
     /**
      * Helper function to return a priority queue of moves for a given board state.
      * Priority queue is ordered by the evaluation of the board should that move be applied.
@@ -150,19 +263,10 @@ private:
      * @return zero if the sum is zero. Otherwise, 100.0 * (p_amt - o_amt) / (p_amt + o_amt)
      */
     double getSumWeight(int p_amt, int o_amt);
-    /**
-      * Scores the given board state. The higher the score, the better the board is for our player (AI).
-      * @return A score reflective of how much the board is in favor of our player.
-      */
-    int evaluate();
     /**
     * Determines whether the game would be finished at the state of the board provided by gameBoard.
     */
     bool isGameComplete(OthelloGameBoard gameBoard);
-    /**
-     * @return Current system time in milliseconds
-     */
-    uint64_t getCurrentSysTime();
 };
 
 
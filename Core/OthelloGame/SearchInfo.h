@@ -0,0 +1,37 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_SEARCHINFO_H
+#define OTHELLOPROJECT_CPP_SEARCHINFO_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Summary of the most recent call to OthelloGameBoard::selectMove.
+ */
+struct SearchInfo {
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    uint64_t timeMs = 0;
+    /**
+     * Rank of the line this is about, from 1 for the best move. Only above 1 in multi-PV searches.
+     */
+    int line = 1;
+};
+
+/**
+ * One of the best moves found by a multi-PV search, with its exact score and principal variation.
+ */
+struct SearchLine {
+    int move = -1;
+    int score = 0;
+    /**
+     * Starts with move.
+     */
+    std::vector<int> pv;
+};
+
+#endif //OTHELLOPROJECT_CPP_SEARCHINFO_H
@@ -0,0 +1,258 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "PerfCounters.h"
+
+#include <atomic>
+#include <cstdio>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define PERF_EVENT_COUNT ((int) PerfEvent::Count)
+
+namespace {
+
+// Set by the first open(): every other thread opens its own counters the first time it asks for them.
+std::atomic<bool> g_enabled(false);
+
+// Per thread: the counters it opened, -1 where opening failed, and the errno of the failure.
+thread_local int t_fds[PERF_EVENT_COUNT] = { -1, -1, -1, -1, -1, -1 };
+thread_local int t_errors[PERF_EVENT_COUNT] = {};
+thread_local bool t_opened = false;
+
+bool openThread();
+
+void ensureOpen() {
+    if(!t_opened && g_enabled.load(std::memory_order_relaxed)) {
+        openThread();
+    }
+}
+
+#if defined(__linux__)
+
+void fillAttr(PerfEvent event, perf_event_attr &attr) {
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // Threads the counting thread starts (the MCTS helpers) are added to its counts once they exit.
+    attr.inherit = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    switch(event) {
+        case PerfEvent::Cycles:
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfEvent::Instructions:
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfEvent::CacheMisses:
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PerfEvent::BranchMisses:
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PerfEvent::TlbMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        default:
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_TASK_CLOCK;
+            break;
+    }
+}
+
+#endif
+
+bool openThread() {
+    PerfCounters::close();
+    t_opened = true;
+
+#if defined(__linux__)
+    bool any = false;
+    for(int i = 0; i < PERF_EVENT_COUNT; i++) {
+        perf_event_attr attr;
+        fillAttr((PerfEvent) i, attr);
+        // This thread and the ones it starts, on any CPU, counting right away.
+        t_fds[i] = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        t_errors[i] = t_fds[i] < 0 ? errno : 0;
+        any = any || t_fds[i] >= 0;
+    }
+    return any;
+#else
+    return false;
+#endif
+}
+
+std::string format(double value) {
+    char text[32];
+    snprintf(text, sizeof(text), value >= 100 ? "%.0f" : value >= 1 ? "%.2f" : "%.3f", value);
+    return text;
+}
+
+}
+
+bool PerfCounters::open() {
+    g_enabled.store(true, std::memory_order_relaxed);
+    return openThread();
+}
+
+void PerfCounters::close() {
+#if defined(__linux__)
+    for(int &fd : t_fds) {
+        if(fd >= 0) {
+            ::close(fd);
+        }
+        fd = -1;
+    }
+#endif
+    t_opened = false;
+}
+
+bool PerfCounters::isOpen() {
+    ensureOpen();
+    for(int fd : t_fds) {
+        if(fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PerfCounters::isAvailable(PerfEvent event) {
+    ensureOpen();
+    return t_fds[(int) event] >= 0;
+}
+
+PerfSample PerfCounters::read() {
+    ensureOpen();
+    PerfSample sample;
+#if defined(__linux__)
+    for(int i = 0; i < PERF_EVENT_COUNT; i++) {
+        // value, time enabled, time running
+        uint64_t values[3];
+        if(t_fds[i] >= 0 && ::read(t_fds[i], values, sizeof(values)) == (ssize_t) sizeof(values)) {
+            sample.valid[i] = true;
+            sample.counts[i] = values[0];
+            sample.enabled[i] = values[1];
+            sample.running[i] = values[2];
+        }
+    }
+#endif
+    return sample;
+}
+
+const char *PerfCounters::getEventName(PerfEvent event) {
+    switch(event) {
+        case PerfEvent::Cycles:
+            return "cycles";
+        case PerfEvent::Instructions:
+            return "instructions";
+        case PerfEvent::CacheMisses:
+            return "cache misses";
+        case PerfEvent::BranchMisses:
+            return "branch misses";
+        case PerfEvent::TlbMisses:
+            return "TLB misses";
+        case PerfEvent::TaskClock:
+            return "task clock";
+        default:
+            return "unknown";
+    }
+}
+
+std::string PerfCounters::getStatus() {
+    if(!t_opened) {
+        return "performance counters not opened";
+    }
+
+    std::string open, missing;
+    for(int i = 0; i < PERF_EVENT_COUNT; i++) {
+        std::string name = getEventName((PerfEvent) i);
+        if(t_fds[i] >= 0) {
+            open += (open.empty() ? "" : ", ") + name;
+        } else {
+#if defined(__linux__)
+            name += std::string(" (") + strerror(t_errors[i]) + ")";
+#endif
+            missing += (missing.empty() ? "" : ", ") + name;
+        }
+    }
+
+    std::string status = "Performance counters: " + (open.empty() ? std::string("none") : open);
+    if(!missing.empty()) {
+        status += "; unavailable: " + missing;
+    }
+    return status;
+}
+
+PerfSample PerfSample::since(const PerfSample &before) const {
+    PerfSample interval;
+    for(int i = 0; i < PERF_EVENT_COUNT; i++) {
+        interval.valid[i] = this->valid[i] && before.valid[i];
+        if(interval.valid[i]) {
+            interval.counts[i] = this->counts[i] - before.counts[i];
+            interval.enabled[i] = this->enabled[i] - before.enabled[i];
+            interval.running[i] = this->running[i] - before.running[i];
+        }
+    }
+    return interval;
+}
+
+PerfSample &PerfSample::operator+=(const PerfSample &other) {
+    for(int i = 0; i < PERF_EVENT_COUNT; i++) {
+        if(other.valid[i]) {
+            this->valid[i] = true;
+            this->counts[i] += other.counts[i];
+            this->enabled[i] += other.enabled[i];
+            this->running[i] += other.running[i];
+        }
+    }
+    return *this;
+}
+
+bool PerfSample::has(PerfEvent event) const {
+    return this->valid[(int) event];
+}
+
+double PerfSample::get(PerfEvent event) const {
+    int i = (int) event;
+    if(!this->valid[i] || this->running[i] == 0) {
+        return 0;
+    }
+    return (double) this->counts[i] * ((double) this->enabled[i] / (double) this->running[i]);
+}
+
+std::string PerfSample::describe(uint64_t nodes, const char *unit) const {
+    std::string s;
+    auto add = [&](const std::string &part) {
+        s += (s.empty() ? "" : ", ") + part;
+    };
+
+    if(this->has(PerfEvent::Cycles) && this->has(PerfEvent::Instructions) && this->get(PerfEvent::Cycles) > 0) {
+        add("IPC " + format(this->get(PerfEvent::Instructions) / this->get(PerfEvent::Cycles)));
+    }
+
+    double perNode = nodes == 0 ? 0 : 1.0 / (double) nodes;
+    for(PerfEvent event : { PerfEvent::Cycles, PerfEvent::Instructions, PerfEvent::CacheMisses,
+                            PerfEvent::BranchMisses, PerfEvent::TlbMisses }) {
+        if(this->has(event) && nodes > 0) {
+            add(format(this->get(event) * perNode) + " " + PerfCounters::getEventName(event) + "/" + unit);
+        }
+    }
+
+    if(this->has(PerfEvent::TaskClock)) {
+        add("task clock " + format(this->get(PerfEvent::TaskClock) / 1e6) + "ms");
+    }
+    return s.empty() ? "no performance counters" : s;
+}
@@ -0,0 +1,98 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_PERFCOUNTERS_H
+#define OTHELLOPROJECT_CPP_PERFCOUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+enum class PerfEvent {
+    Cycles,
+    Instructions,
+    /**
+     * Last-level cache misses.
+     */
+    CacheMisses,
+    BranchMisses,
+    /**
+     * Data TLB read misses.
+     */
+    TlbMisses,
+    /**
+     * CPU time of the thread in nanoseconds. A software counter, so usually available when the
+     * hardware ones are not (virtual machines, containers).
+     */
+    TaskClock,
+    Count
+};
+
+/**
+ * Counter values at one point in time, or (after subtracting) over an interval.
+ */
+struct PerfSample {
+    bool valid[(int) PerfEvent::Count] = {};
+    uint64_t counts[(int) PerfEvent::Count] = {};
+    /**
+     * Time the counter was enabled and actually counting. They differ when the kernel multiplexes
+     * more counters than the hardware has, and counts are scaled up by their ratio.
+     */
+    uint64_t enabled[(int) PerfEvent::Count] = {};
+    uint64_t running[(int) PerfEvent::Count] = {};
+
+    /**
+     * @return The interval from before to this sample.
+     */
+    PerfSample since(const PerfSample &before) const;
+    PerfSample &operator+=(const PerfSample &other);
+    bool has(PerfEvent event) const;
+    /**
+     * @return The count scaled for multiplexing, 0 if the counter is not available.
+     */
+    double get(PerfEvent event) const;
+    /**
+     * @return Instructions per cycle and the counts per node, e.g. for log comments. Counters that
+     * are not available are left out.
+     * @param unit What nodes counts, for the labels.
+     */
+    std::string describe(uint64_t nodes, const char *unit = "node") const;
+};
+
+/**
+ * Hardware performance counters through Linux perf_event_open: cycles, instructions, cache misses,
+ * branch misses and TLB misses, plus the task clock.
+ *
+ * Counters are opened per thread and count that thread, and the threads it starts once they have
+ * exited, in user space. Once open() has been called on any thread, every other thread opens its
+ * own the first time it reads them, so searches on the protocol's search thread are counted too.
+ * selectMove, MCTS searches and the benchmarks read them around their searches and report IPC and
+ * the counts per node. Every counter is opened on its own, so missing hardware support, a restrictive
+ * perf_event_paranoid or a system other than Linux only leaves the affected counters out; without
+ * any counter, read() returns an empty sample and nothing is reported.
+ */
+class PerfCounters {
+public:
+    /**
+     * Opens every counter for the calling thread, and turns counting on for all other threads.
+     * @return False if none of them could be opened.
+     */
+    static bool open();
+    static void close();
+    /**
+     * @return True if the calling thread has at least one counter open. Opens them if counting is on.
+     */
+    static bool isOpen();
+    static bool isAvailable(PerfEvent event);
+    /**
+     * @return The calling thread's counts so far. Empty unless counting is on.
+     */
+    static PerfSample read();
+    static const char *getEventName(PerfEvent event);
+    /**
+     * @return Which counters are open and why the others are not.
+     */
+    static std::string getStatus();
+};
+
+#endif //OTHELLOPROJECT_CPP_PERFCOUNTERS_H
@@ -0,0 +1,85 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_BYTEIO_H
+#define OTHELLOPROJECT_CPP_BYTEIO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Little-endian integer and varint helpers shared by the on-disk formats.
+ * Files are always little-endian regardless of host.
+ */
+class ByteIO {
+public:
+    static inline void putU16(uint8_t *p, uint16_t v) {
+        p[0] = (uint8_t) v;
+        p[1] = (uint8_t) (v >> 8);
+    }
+
+    static inline void putU32(uint8_t *p, uint32_t v) {
+        for(int i = 0; i < 4; i++) {
+            p[i] = (uint8_t) (v >> (8 * i));
+        }
+    }
+
+    static inline void putU64(uint8_t *p, uint64_t v) {
+        for(int i = 0; i < 8; i++) {
+            p[i] = (uint8_t) (v >> (8 * i));
+        }
+    }
+
+    static inline uint16_t getU16(const uint8_t *p) {
+        return (uint16_t) (p[0] | (p[1] << 8));
+    }
+
+    static inline uint32_t getU32(const uint8_t *p) {
+        uint32_t v = 0;
+        for(int i = 3; i >= 0; i--) {
+            v = (v << 8) | p[i];
+        }
+        return v;
+    }
+
+    static inline uint64_t getU64(const uint8_t *p) {
+        uint64_t v = 0;
+        for(int i = 7; i >= 0; i--) {
+            v = (v << 8) | p[i];
+        }
+        return v;
+    }
+
+    /**
+     * Appends v as an LEB128 varint (7 bits per byte, high bit = continuation).
+     */
+    static inline void putVarint(std::vector<uint8_t> &out, uint64_t v) {
+        while(v >= 0x80) {
+            out.push_back((uint8_t) (v | 0x80));
+            v >>= 7;
+        }
+        out.push_back((uint8_t) v);
+    }
+
+    /**
+     * Reads a varint written by putVarint.
+     * @param p Advanced past the varint.
+     * @param end End of the readable data.
+     * @return False if the data ran out before the varint was complete.
+     */
+    static inline bool getVarint(const uint8_t *&p, const uint8_t *end, uint64_t &v) {
+        v = 0;
+        for(int shift = 0; shift < 64 && p < end; shift += 7) {
+            uint8_t byte = *p++;
+            v |= (uint64_t) (byte & 0x7F) << shift;
+            if((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+#endif //OTHELLOPROJECT_CPP_BYTEIO_H
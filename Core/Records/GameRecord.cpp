@@ -0,0 +1,167 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "GameRecord.h"
+#include "ByteIO.h"
+
+// Header field offsets
+#define OFF_MAGIC 0
+#define OFF_FLAGS 4
+#define OFF_MOVE_COUNT 5
+#define OFF_AGENT_COLOR 6
+#define OFF_BLACK_DISCS 7
+#define OFF_WHITE_DISCS 8
+#define OFF_GAME_TIME 10
+#define OFF_TIMESTAMP 12
+
+bool GameRecord::hasStats() const {
+    return !this->stats.empty();
+}
+
+void GameRecord::addMove(int pos, const MoveStats *moveStats) {
+    this->moves.push_back(pos < 0 || pos > 63 ? RECORD_PASS : (uint8_t) pos);
+
+    // Once any move carries stats, every move must, so back-fill earlier moves with zeroes.
+    if(moveStats != nullptr && this->stats.size() < this->moves.size() - 1) {
+        this->stats.resize(this->moves.size() - 1);
+    }
+    if(moveStats != nullptr) {
+        this->stats.push_back(*moveStats);
+    } else if(!this->stats.empty()) {
+        this->stats.emplace_back();
+    }
+}
+
+size_t GameRecordCodec::encodedSize(const GameRecord &record) {
+    size_t size = HEADER_SIZE + record.moves.size();
+    if(record.hasStats()) {
+        size += record.moves.size() * STATS_SIZE;
+    }
+    return size;
+}
+
+void GameRecordCodec::encode(const GameRecord &record, std::vector<uint8_t> &out) {
+    size_t start = out.size();
+    size_t count = record.moves.size() > 255 ? 255 : record.moves.size();
+    bool stats = record.hasStats() && record.stats.size() >= count;
+
+    out.resize(start + HEADER_SIZE + count + (stats ? count * STATS_SIZE : 0), 0);
+    uint8_t *p = out.data() + start;
+
+    ByteIO::putU32(p + OFF_MAGIC, MAGIC);
+    p[OFF_FLAGS] = stats ? RECORD_FLAG_STATS : 0;
+    p[OFF_MOVE_COUNT] = (uint8_t) count;
+    p[OFF_AGENT_COLOR] = (uint8_t) record.agentColor;
+    p[OFF_BLACK_DISCS] = record.blackDiscs;
+    p[OFF_WHITE_DISCS] = record.whiteDiscs;
+    ByteIO::putU16(p + OFF_GAME_TIME, record.gameTime);
+    ByteIO::putU32(p + OFF_TIMESTAMP, record.timestamp);
+
+    p += HEADER_SIZE;
+    for(size_t i = 0; i < count; i++) {
+        *p++ = record.moves[i];
+    }
+
+    if(stats) {
+        for(size_t i = 0; i < count; i++) {
+            const MoveStats &s = record.stats[i];
+            ByteIO::putU32(p, (uint32_t) s.score);
+            ByteIO::putU32(p + 4, s.timeMs);
+            ByteIO::putU64(p + 8, s.nodes);
+            p[16] = s.depth;
+            p += STATS_SIZE;
+        }
+    }
+}
+
+size_t GameRecordCodec::peekLength(const uint8_t *data, size_t available) {
+    if(available < HEADER_SIZE || ByteIO::getU32(data + OFF_MAGIC) != MAGIC) {
+        return 0;
+    }
+
+    size_t count = data[OFF_MOVE_COUNT];
+    size_t length = HEADER_SIZE + count;
+    if(data[OFF_FLAGS] & RECORD_FLAG_STATS) {
+        length += count * STATS_SIZE;
+    }
+
+    return length <= available ? length : 0;
+}
+
+size_t GameRecordCodec::decode(const uint8_t *data, size_t available, GameRecord &out) {
+    size_t length = peekLength(data, available);
+    if(length == 0) {
+        return 0;
+    }
+
+    out = GameRecordView{data, length}.toRecord();
+    return length;
+}
+
+int GameRecordView::agentColor() const {
+    return (int8_t) this->data[OFF_AGENT_COLOR];
+}
+
+int GameRecordView::blackDiscs() const {
+    return this->data[OFF_BLACK_DISCS];
+}
+
+int GameRecordView::whiteDiscs() const {
+    return this->data[OFF_WHITE_DISCS];
+}
+
+uint32_t GameRecordView::timestamp() const {
+    return ByteIO::getU32(this->data + OFF_TIMESTAMP);
+}
+
+int GameRecordView::gameTime() const {
+    return ByteIO::getU16(this->data + OFF_GAME_TIME);
+}
+
+int GameRecordView::moveCount() const {
+    return this->data[OFF_MOVE_COUNT];
+}
+
+bool GameRecordView::hasStats() const {
+    return (this->data[OFF_FLAGS] & RECORD_FLAG_STATS) != 0;
+}
+
+int GameRecordView::move(int ply) const {
+    return this->data[GameRecordCodec::HEADER_SIZE + ply];
+}
+
+MoveStats GameRecordView::stats(int ply) const {
+    MoveStats s;
+    if(!this->hasStats()) {
+        return s;
+    }
+
+    const uint8_t *p = this->data + GameRecordCodec::HEADER_SIZE + this->moveCount() + ply * GameRecordCodec::STATS_SIZE;
+    s.score = (int32_t) ByteIO::getU32(p);
+    s.timeMs = ByteIO::getU32(p + 4);
+    s.nodes = ByteIO::getU64(p + 8);
+    s.depth = p[16];
+    return s;
+}
+
+GameRecord GameRecordView::toRecord() const {
+    GameRecord record;
+    record.agentColor = (int8_t) this->agentColor();
+    record.blackDiscs = (uint8_t) this->blackDiscs();
+    record.whiteDiscs = (uint8_t) this->whiteDiscs();
+    record.timestamp = this->timestamp();
+    record.gameTime = (uint16_t) this->gameTime();
+
+    int count = this->moveCount();
+    record.moves.assign(this->data + GameRecordCodec::HEADER_SIZE, this->data + GameRecordCodec::HEADER_SIZE + count);
+
+    if(this->hasStats()) {
+        record.stats.reserve(count);
+        for(int i = 0; i < count; i++) {
+            record.stats.push_back(this->stats(i));
+        }
+    }
+
+    return record;
+}
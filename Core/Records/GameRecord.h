@@ -0,0 +1,126 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_GAMERECORD_H
+#define OTHELLOPROJECT_CPP_GAMERECORD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Stored in place of a board position for a move that is a pass.
+#define RECORD_PASS 64
+
+// Record flag: per-move search statistics follow the move bytes.
+#define RECORD_FLAG_STATS 0x01
+
+/**
+ * Search statistics attached to a single recorded move. Moves that were not
+ * produced by a search (human / referee moves) carry all zeroes.
+ */
+struct MoveStats {
+    int32_t score = 0;
+    uint32_t timeMs = 0;
+    uint64_t nodes = 0;
+    uint8_t depth = 0;
+};
+
+/**
+ * A single complete game.
+ *
+ * On-disk layout (little-endian, no padding):
+ *
+ *   [RecordHeader : 16 bytes]
+ *   [moves        : moveCount bytes, 0-63 = board position (H8 = 0), 64 = pass]
+ *   [stats        : moveCount * 17 bytes, only if RECORD_FLAG_STATS is set]
+ *                   int32 score, uint32 timeMs, uint64 nodes, uint8 depth
+ *
+ * Moves always alternate starting with black, so passes are stored explicitly.
+ */
+struct GameRecord {
+    /**
+     * The color the agent played as (BLACK / WHITE, from Color.h), 0 for imported games.
+     */
+    int8_t agentColor = 0;
+    uint8_t blackDiscs = 0;
+    uint8_t whiteDiscs = 0;
+    /**
+     * Seconds since the unix epoch at which the game finished.
+     */
+    uint32_t timestamp = 0;
+    /**
+     * Time allotted to each player, in seconds.
+     */
+    uint16_t gameTime = 0;
+    std::vector<uint8_t> moves;
+    /**
+     * Either empty or exactly moves.size() long.
+     */
+    std::vector<MoveStats> stats;
+
+    bool hasStats() const;
+    /**
+     * Appends a move (and optional statistics) to the record.
+     * @param pos Board position 0-63, or any other value for a pass.
+     */
+    void addMove(int pos, const MoveStats *moveStats = nullptr);
+};
+
+/**
+ * Binary (de)serialization of GameRecords. All functions work on raw byte buffers so the
+ * same code is shared by the buffered writer and the memory-mapped reader.
+ */
+class GameRecordCodec {
+public:
+    static const uint32_t MAGIC = 0x3152474F; // "OGR1"
+    static const size_t HEADER_SIZE = 16;
+    static const size_t STATS_SIZE = 17;
+
+    /**
+     * @return Number of bytes the record will occupy once encoded.
+     */
+    static size_t encodedSize(const GameRecord &record);
+    /**
+     * Appends the encoded record to out.
+     */
+    static void encode(const GameRecord &record, std::vector<uint8_t> &out);
+    /**
+     * Peeks the total encoded length of the record starting at data.
+     * @return The record length in bytes, or 0 if the data does not hold a valid record header.
+     */
+    static size_t peekLength(const uint8_t *data, size_t available);
+    /**
+     * Decodes a record starting at data.
+     * @return The number of bytes consumed, or 0 if the record is truncated or corrupt.
+     */
+    static size_t decode(const uint8_t *data, size_t available, GameRecord &out);
+};
+
+/**
+ * Lightweight, non-owning view of an encoded record. Used by the reader so that scanning
+ * millions of records does not copy move data into vectors.
+ */
+struct GameRecordView {
+    const uint8_t *data = nullptr;
+    size_t length = 0;
+
+    int agentColor() const;
+    int blackDiscs() const;
+    int whiteDiscs() const;
+    uint32_t timestamp() const;
+    int gameTime() const;
+    int moveCount() const;
+    bool hasStats() const;
+    /**
+     * @return The board position of the ply, or RECORD_PASS.
+     */
+    int move(int ply) const;
+    MoveStats stats(int ply) const;
+    /**
+     * Copies the view into an owning GameRecord.
+     */
+    GameRecord toRecord() const;
+};
+
+#endif //OTHELLOPROJECT_CPP_GAMERECORD_H
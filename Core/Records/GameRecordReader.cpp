@@ -0,0 +1,118 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "GameRecordReader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+GameRecordReader::GameRecordReader(const std::string &path) : m_data(nullptr), m_size(0), m_offset(0), m_skipped(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        return;
+    }
+
+    struct stat st{};
+    if(fstat(fd, &st) == 0 && st.st_size > 0) {
+        void *mapped = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapped != MAP_FAILED) {
+            madvise(mapped, (size_t) st.st_size, MADV_SEQUENTIAL);
+            m_data = (const uint8_t *) mapped;
+            m_size = (size_t) st.st_size;
+        }
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+}
+
+GameRecordReader::~GameRecordReader() {
+    if(m_data != nullptr) {
+        munmap((void *) m_data, m_size);
+    }
+}
+
+bool GameRecordReader::isOpen() const {
+    return m_data != nullptr;
+}
+
+size_t GameRecordReader::getSize() const {
+    return m_size;
+}
+
+bool GameRecordReader::next(GameRecordView &view) {
+    while(m_offset < m_size) {
+        size_t length = GameRecordCodec::peekLength(m_data + m_offset, m_size - m_offset);
+        if(length > 0) {
+            view.data = m_data + m_offset;
+            view.length = length;
+            m_offset += length;
+            return true;
+        }
+
+        // Resynchronize on the next byte that could start a record header.
+        size_t start = m_offset++;
+        const uint8_t first = (uint8_t) (GameRecordCodec::MAGIC & 0xFF);
+        const uint8_t *found = (const uint8_t *) memchr(m_data + m_offset, first, m_size - m_offset);
+        m_offset = found == nullptr ? m_size : (size_t) (found - m_data);
+        m_skipped += m_offset - start;
+    }
+
+    return false;
+}
+
+void GameRecordReader::rewind() {
+    m_offset = 0;
+    m_skipped = 0;
+}
+
+size_t GameRecordReader::getSkippedBytes() const {
+    return m_skipped;
+}
+
+long long GameRecordReader::forEach(const std::string &path,
+                                    const std::function<void(const GameRecordView &)> &callback) {
+    GameRecordReader reader(path);
+    if(!reader.isOpen()) {
+        return -1;
+    }
+
+    long long count = 0;
+    GameRecordView view;
+    while(reader.next(view)) {
+        callback(view);
+        count++;
+    }
+
+    return count;
+}
+
+long long GameRecordReader::forEachInDirectory(const std::string &directory,
+                                               const std::function<void(const GameRecordView &)> &callback) {
+    std::vector<std::string> paths;
+    std::error_code ec;
+    for(const auto &entry : std::filesystem::directory_iterator(directory, ec)) {
+        if(entry.path().extension() == ".ogr") {
+            paths.push_back(entry.path().string());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    long long count = 0;
+    for(const auto &path : paths) {
+        long long visited = forEach(path, callback);
+        if(visited > 0) {
+            count += visited;
+        }
+    }
+
+    return count;
+}
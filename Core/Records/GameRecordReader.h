@@ -0,0 +1,66 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_GAMERECORDREADER_H
+#define OTHELLOPROJECT_CPP_GAMERECORDREADER_H
+
+#include <functional>
+#include <string>
+
+#include "GameRecord.h"
+
+/**
+ * Streams GameRecords out of a record file through a read-only memory mapping.
+ * Records are handed out as GameRecordView objects pointing straight into the mapping,
+ * so a scan does not allocate per record.
+ */
+class GameRecordReader {
+public:
+    /**
+     * Maps the file at path. Check isOpen() afterwards.
+     */
+    explicit GameRecordReader(const std::string &path);
+    ~GameRecordReader();
+
+    GameRecordReader(const GameRecordReader &) = delete;
+    GameRecordReader &operator=(const GameRecordReader &) = delete;
+
+    bool isOpen() const;
+    size_t getSize() const;
+    /**
+     * Moves to the next record in the file. Corrupt or partially written regions are
+     * skipped by searching for the next record header.
+     * @param view Set to the next record on success.
+     * @return False once the end of the file has been reached.
+     */
+    bool next(GameRecordView &view);
+    /**
+     * Restarts the scan from the beginning of the file.
+     */
+    void rewind();
+    /**
+     * @return Number of bytes skipped so far because they did not hold a valid record.
+     */
+    size_t getSkippedBytes() const;
+
+    /**
+     * Calls the callback for every record in the file.
+     * @return The number of records visited, or -1 if the file could not be opened.
+     */
+    static long long forEach(const std::string &path, const std::function<void(const GameRecordView &)> &callback);
+    /**
+     * Calls the callback for every record of every *.ogr file in directory, in file name order.
+     * @return The number of records visited.
+     */
+    static long long forEachInDirectory(const std::string &directory,
+                                        const std::function<void(const GameRecordView &)> &callback);
+
+private:
+    const uint8_t *m_data;
+    size_t m_size;
+    size_t m_offset;
+    size_t m_skipped;
+};
+
+#endif //OTHELLOPROJECT_CPP_GAMERECORDREADER_H
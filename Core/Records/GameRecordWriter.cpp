@@ -0,0 +1,112 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "GameRecordWriter.h"
+
+#include <filesystem>
+
+GameRecordWriter::GameRecordWriter(const std::string &directory, const std::string &prefix, size_t maxFileBytes,
+                                   size_t bufferBytes) :
+        m_directory(directory), m_prefix(prefix), m_maxFileBytes(maxFileBytes), m_bufferBytes(bufferBytes),
+        m_file(nullptr), m_fileIndex(0), m_fileSize(0), m_recordCount(0) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    // Continue after the highest existing file so that restarts never overwrite old games.
+    std::string head = prefix + "-";
+    for(const auto &entry : std::filesystem::directory_iterator(directory, ec)) {
+        std::string name = entry.path().filename().string();
+        if(name.rfind(head, 0) != 0 || entry.path().extension() != ".ogr") {
+            continue;
+        }
+
+        int index = std::atoi(name.c_str() + head.size());
+        if(index > m_fileIndex) {
+            m_fileIndex = index;
+        }
+    }
+
+    m_buffer.reserve(bufferBytes + 4096);
+    this->openCurrent();
+}
+
+GameRecordWriter::~GameRecordWriter() {
+    this->flush();
+    if(m_file != nullptr) {
+        std::fclose(m_file);
+    }
+}
+
+bool GameRecordWriter::append(const GameRecord &record) {
+    size_t size = GameRecordCodec::encodedSize(record);
+
+    // Rotate before the record would overflow the current file. A record larger than the
+    // limit on its own still gets written to a fresh file.
+    if(m_fileSize + m_buffer.size() + size > m_maxFileBytes && m_fileSize + m_buffer.size() > 0) {
+        if(!this->flush() || !this->rotate()) {
+            return false;
+        }
+    }
+
+    GameRecordCodec::encode(record, m_buffer);
+    m_recordCount++;
+
+    if(m_buffer.size() >= m_bufferBytes) {
+        return this->flush();
+    }
+    return true;
+}
+
+bool GameRecordWriter::flush() {
+    if(m_buffer.empty()) {
+        return true;
+    }
+    if(m_file == nullptr && !this->openCurrent()) {
+        return false;
+    }
+
+    size_t written = std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+    std::fflush(m_file);
+    m_fileSize += written;
+
+    bool ok = written == m_buffer.size();
+    m_buffer.clear();
+    return ok;
+}
+
+std::string GameRecordWriter::currentPath() const {
+    return this->pathFor(m_fileIndex);
+}
+
+uint64_t GameRecordWriter::getRecordCount() const {
+    return m_recordCount;
+}
+
+bool GameRecordWriter::openCurrent() {
+    m_file = std::fopen(this->currentPath().c_str(), "ab");
+    if(m_file == nullptr) {
+        return false;
+    }
+
+    std::fseek(m_file, 0, SEEK_END);
+    m_fileSize = (size_t) std::ftell(m_file);
+    return true;
+}
+
+bool GameRecordWriter::rotate() {
+    if(m_file != nullptr) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+    m_fileIndex++;
+    m_fileSize = 0;
+    return this->openCurrent();
+}
+
+std::string GameRecordWriter::pathFor(int index) const {
+    char name[32];
+    snprintf(name, sizeof(name), "-%06d.ogr", index);
+    return (std::filesystem::path(m_directory) / (m_prefix + name)).string();
+}
@@ -0,0 +1,79 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_GAMERECORDWRITER_H
+#define OTHELLOPROJECT_CPP_GAMERECORDWRITER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "GameRecord.h"
+
+/**
+ * Appends encoded GameRecords to a set of rotating files in a directory:
+ *   <dir>/<prefix>-000000.ogr, <dir>/<prefix>-000001.ogr, ...
+ *
+ * Records are buffered in memory and written out in large chunks. A record never spans two
+ * files, so every file can be scanned on its own. When the writer is created it continues
+ * after the highest-numbered existing file in the directory.
+ */
+class GameRecordWriter {
+public:
+    /**
+     * @param directory Directory to write to. Created if it does not exist.
+     * @param prefix File name prefix.
+     * @param maxFileBytes Size after which a new file is started.
+     * @param bufferBytes Amount of encoded data held in memory before it is written to disk.
+     */
+    GameRecordWriter(const std::string &directory, const std::string &prefix = "games",
+                     size_t maxFileBytes = 64 * 1024 * 1024, size_t bufferBytes = 64 * 1024);
+    ~GameRecordWriter();
+
+    GameRecordWriter(const GameRecordWriter &) = delete;
+    GameRecordWriter &operator=(const GameRecordWriter &) = delete;
+
+    /**
+     * Queues a record for writing.
+     * @return False if the record could not be written out (e.g. the directory is not writable).
+     */
+    bool append(const GameRecord &record);
+    /**
+     * Writes all buffered records to disk.
+     * @return False on I/O failure.
+     */
+    bool flush();
+    /**
+     * @return Path of the file records are currently appended to.
+     */
+    std::string currentPath() const;
+    /**
+     * @return Total number of records appended through this writer.
+     */
+    uint64_t getRecordCount() const;
+
+private:
+    std::string m_directory;
+    std::string m_prefix;
+    size_t m_maxFileBytes;
+    size_t m_bufferBytes;
+
+    std::vector<uint8_t> m_buffer;
+    std::FILE *m_file;
+    int m_fileIndex;
+    size_t m_fileSize;
+    uint64_t m_recordCount;
+
+    /**
+     * Opens m_fileIndex for appending, picking up its current size.
+     */
+    bool openCurrent();
+    /**
+     * Closes the current file and moves on to the next index.
+     */
+    bool rotate();
+    std::string pathFor(int index) const;
+};
+
+#endif //OTHELLOPROJECT_CPP_GAMERECORDWRITER_H
@@ -0,0 +1,295 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "PositionStore.h"
+#include "ByteIO.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Header field offsets
+#define OFF_MAGIC 0
+#define OFF_VERSION 4
+#define OFF_ENTRY_COUNT 8
+#define OFF_BLOCK_COUNT 16
+#define OFF_BLOCK_ENTRIES 20
+#define OFF_INDEX 24
+
+bool PositionMeta::isSolved() const {
+    return this->solvedScore != POSITION_NO_SCORE;
+}
+
+void PositionMeta::merge(const PositionMeta &other) {
+    this->visits += other.visits;
+
+    if(!this->isSolved() && other.isSolved()) {
+        this->solvedScore = other.solvedScore;
+        this->bestMove = other.bestMove;
+    } else if(this->bestMove == POSITION_NO_MOVE) {
+        this->bestMove = other.bestMove;
+    }
+}
+
+bool PositionKey::operator==(const PositionKey &other) const {
+    return this->player == other.player && this->opponent == other.opponent;
+}
+
+bool PositionKey::operator<(const PositionKey &other) const {
+    return this->player < other.player || (this->player == other.player && this->opponent < other.opponent);
+}
+
+size_t PositionStoreBuilder::KeyHash::operator()(const PositionKey &key) const {
+    uint64_t h = key.player * 0x9E3779B97F4A7C15ULL ^ (key.opponent + 0x632BE59BD9B4E019ULL);
+    return (size_t) (h ^ (h >> 29));
+}
+
+void PositionStoreBuilder::add(uint64_t player, uint64_t opponent, const PositionMeta &meta) {
+    int symmetry = Symmetry::canonicalize(player, opponent);
+
+    PositionMeta canonical = meta;
+    if(canonical.bestMove < 64) {
+        canonical.bestMove = (uint8_t) Symmetry::transformPos(canonical.bestMove, symmetry);
+    }
+
+    auto inserted = m_entries.emplace(PositionKey{player, opponent}, canonical);
+    if(!inserted.second) {
+        inserted.first->second.merge(canonical);
+    }
+}
+
+void PositionStoreBuilder::addAll(const PositionStore &store) {
+    store.forEach([this](const PositionKey &key, const PositionMeta &meta) {
+        // Stored keys are canonical already, so the symmetry found here is the identity.
+        this->add(key.player, key.opponent, meta);
+    });
+}
+
+void PositionStoreBuilder::addAll(const PositionStoreBuilder &other) {
+    for(const auto &entry : other.m_entries) {
+        auto inserted = m_entries.insert(entry);
+        if(!inserted.second) {
+            inserted.first->second.merge(entry.second);
+        }
+    }
+}
+
+size_t PositionStoreBuilder::size() const {
+    return m_entries.size();
+}
+
+bool PositionStoreBuilder::write(const std::string &path, int entriesPerBlock) const {
+    if(entriesPerBlock < 1) {
+        entriesPerBlock = 1;
+    }
+
+    std::vector<std::pair<PositionKey, PositionMeta>> sorted(m_entries.begin(), m_entries.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+        return a.first < b.first;
+    });
+
+    std::vector<uint8_t> out(PositionStore::HEADER_SIZE, 0);
+    std::vector<uint8_t> index;
+    uint32_t blockCount = 0;
+
+    for(size_t start = 0; start < sorted.size(); start += entriesPerBlock) {
+        size_t end = std::min(sorted.size(), start + entriesPerBlock);
+        size_t offset = out.size();
+        PositionKey prev = sorted[start].first;
+
+        for(size_t i = start; i < end; i++) {
+            const PositionKey &key = sorted[i].first;
+            const PositionMeta &meta = sorted[i].second;
+
+            uint64_t playerDelta = key.player - prev.player;
+            ByteIO::putVarint(out, playerDelta);
+            ByteIO::putVarint(out, playerDelta == 0 ? key.opponent - prev.opponent : key.opponent ^ prev.opponent);
+            out.push_back((uint8_t) meta.solvedScore);
+            out.push_back(meta.bestMove);
+            ByteIO::putVarint(out, meta.visits);
+
+            prev = key;
+        }
+
+        uint8_t entry[PositionStore::INDEX_ENTRY_SIZE];
+        ByteIO::putU64(entry, sorted[start].first.player);
+        ByteIO::putU64(entry + 8, sorted[start].first.opponent);
+        ByteIO::putU64(entry + 16, offset);
+        ByteIO::putU32(entry + 24, (uint32_t) (end - start));
+        ByteIO::putU32(entry + 28, (uint32_t) (out.size() - offset));
+        index.insert(index.end(), entry, entry + PositionStore::INDEX_ENTRY_SIZE);
+
+        blockCount++;
+    }
+
+    uint64_t indexOffset = out.size();
+    out.insert(out.end(), index.begin(), index.end());
+
+    ByteIO::putU32(out.data() + OFF_MAGIC, PositionStore::MAGIC);
+    ByteIO::putU32(out.data() + OFF_VERSION, PositionStore::VERSION);
+    ByteIO::putU64(out.data() + OFF_ENTRY_COUNT, sorted.size());
+    ByteIO::putU32(out.data() + OFF_BLOCK_COUNT, blockCount);
+    ByteIO::putU32(out.data() + OFF_BLOCK_ENTRIES, (uint32_t) entriesPerBlock);
+    ByteIO::putU64(out.data() + OFF_INDEX, indexOffset);
+
+    // Write to a temporary file first so readers never map a half-written store.
+    std::string tmpPath = path + ".tmp";
+    std::FILE *file = std::fopen(tmpPath.c_str(), "wb");
+    if(file == nullptr) {
+        return false;
+    }
+
+    bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    ok = std::fclose(file) == 0 && ok;
+
+    return ok && std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+PositionStore::PositionStore(const std::string &path) :
+        m_data(nullptr), m_size(0), m_entryCount(0), m_blockCount(0), m_index(nullptr) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        return;
+    }
+
+    struct stat st{};
+    if(fstat(fd, &st) == 0 && (size_t) st.st_size >= HEADER_SIZE) {
+        void *mapped = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if(mapped != MAP_FAILED) {
+            m_data = (const uint8_t *) mapped;
+            m_size = (size_t) st.st_size;
+        }
+    }
+    close(fd);
+
+    if(m_data == nullptr) {
+        return;
+    }
+
+    uint64_t indexOffset = ByteIO::getU64(m_data + OFF_INDEX);
+    uint32_t blockCount = ByteIO::getU32(m_data + OFF_BLOCK_COUNT);
+    bool valid = ByteIO::getU32(m_data + OFF_MAGIC) == MAGIC && ByteIO::getU32(m_data + OFF_VERSION) == VERSION &&
+                 indexOffset <= m_size && (m_size - indexOffset) / INDEX_ENTRY_SIZE >= blockCount;
+
+    if(!valid) {
+        munmap((void *) m_data, m_size);
+        m_data = nullptr;
+        m_size = 0;
+        return;
+    }
+
+    m_entryCount = ByteIO::getU64(m_data + OFF_ENTRY_COUNT);
+    m_blockCount = blockCount;
+    m_index = m_data + indexOffset;
+}
+
+PositionStore::~PositionStore() {
+    if(m_data != nullptr) {
+        munmap((void *) m_data, m_size);
+    }
+}
+
+bool PositionStore::isOpen() const {
+    return m_data != nullptr;
+}
+
+uint64_t PositionStore::size() const {
+    return m_entryCount;
+}
+
+PositionKey PositionStore::blockKey(uint32_t block) const {
+    const uint8_t *entry = m_index + (size_t) block * INDEX_ENTRY_SIZE;
+    return PositionKey{ByteIO::getU64(entry), ByteIO::getU64(entry + 8)};
+}
+
+void PositionStore::scanBlock(uint32_t block,
+                              const std::function<bool(const PositionKey &, const PositionMeta &)> &callback) const {
+    const uint8_t *entry = m_index + (size_t) block * INDEX_ENTRY_SIZE;
+    uint64_t offset = ByteIO::getU64(entry + 16);
+    uint32_t count = ByteIO::getU32(entry + 24);
+    uint32_t bytes = ByteIO::getU32(entry + 28);
+
+    if(offset > m_size || bytes > m_size - offset) {
+        return;
+    }
+
+    const uint8_t *p = m_data + offset;
+    const uint8_t *end = p + bytes;
+    PositionKey key = this->blockKey(block);
+
+    for(uint32_t i = 0; i < count; i++) {
+        uint64_t playerDelta, opponentCode, visits;
+        if(!ByteIO::getVarint(p, end, playerDelta) || !ByteIO::getVarint(p, end, opponentCode) || end - p < 2) {
+            return;
+        }
+
+        key.opponent = playerDelta == 0 ? key.opponent + opponentCode : key.opponent ^ opponentCode;
+        key.player += playerDelta;
+
+        PositionMeta meta;
+        meta.solvedScore = (int8_t) *p++;
+        meta.bestMove = *p++;
+        if(!ByteIO::getVarint(p, end, visits)) {
+            return;
+        }
+        meta.visits = (uint32_t) visits;
+
+        if(!callback(key, meta)) {
+            return;
+        }
+    }
+}
+
+bool PositionStore::lookup(uint64_t player, uint64_t opponent, PositionMeta &meta) const {
+    if(m_blockCount == 0) {
+        return false;
+    }
+
+    int symmetry = Symmetry::canonicalize(player, opponent);
+    PositionKey target{player, opponent};
+
+    // Find the last block whose first key is <= target.
+    uint32_t lo = 0, hi = m_blockCount;
+    while(lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if(target < this->blockKey(mid)) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    if(lo == 0) {
+        return false;
+    }
+
+    bool found = false;
+    this->scanBlock(lo - 1, [&](const PositionKey &key, const PositionMeta &entry) {
+        if(key == target) {
+            meta = entry;
+            found = true;
+        }
+        // Entries are sorted, so stop once we are past the target.
+        return key < target;
+    });
+
+    if(found && meta.bestMove < 64) {
+        meta.bestMove = (uint8_t) Symmetry::inversePos(meta.bestMove, symmetry);
+    }
+
+    return found;
+}
+
+void PositionStore::forEach(const std::function<void(const PositionKey &, const PositionMeta &)> &callback) const {
+    for(uint32_t block = 0; block < m_blockCount; block++) {
+        this->scanBlock(block, [&](const PositionKey &key, const PositionMeta &meta) {
+            callback(key, meta);
+            return true;
+        });
+    }
+}
@@ -0,0 +1,152 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_POSITIONSTORE_H
+#define OTHELLOPROJECT_CPP_POSITIONSTORE_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+#include "Symmetry.h"
+
+// PositionMeta::solvedScore value for positions without an exact result.
+#define POSITION_NO_SCORE -128
+// PositionMeta::bestMove value for positions without a known best move.
+#define POSITION_NO_MOVE 255
+
+/**
+ * Data attached to a stored position. Scores and moves are always from the point of view
+ * of the side to move.
+ */
+struct PositionMeta {
+    /**
+     * Final disc differential with perfect play, or POSITION_NO_SCORE.
+     */
+    int8_t solvedScore = POSITION_NO_SCORE;
+    /**
+     * Best move as a board position (0-63), RECORD_PASS (64) or POSITION_NO_MOVE.
+     */
+    uint8_t bestMove = POSITION_NO_MOVE;
+    /**
+     * Number of times the position was seen (games, searches, imports...).
+     */
+    uint32_t visits = 0;
+
+    bool isSolved() const;
+    /**
+     * Combines two entries for the same position: visits add up, and solved
+     * scores / best moves from other fill in unknown values.
+     */
+    void merge(const PositionMeta &other);
+};
+
+/**
+ * A position as stored: the canonical image of (side to move, other side).
+ */
+struct PositionKey {
+    uint64_t player;
+    uint64_t opponent;
+
+    bool operator==(const PositionKey &other) const;
+    bool operator<(const PositionKey &other) const;
+};
+
+class PositionStore;
+
+/**
+ * Collects positions in memory, deduplicating them over the eight board symmetries,
+ * and writes them out as a PositionStore file.
+ */
+class PositionStoreBuilder {
+public:
+    /**
+     * Adds a position. The position is canonicalized; a best move in meta is given in the
+     * frame of the position passed in and is mapped along with it.
+     * @param player Bits of the side to move.
+     * @param opponent Bits of the other side.
+     */
+    void add(uint64_t player, uint64_t opponent, const PositionMeta &meta);
+    /**
+     * Merges every entry of an existing store, e.g. to extend a file across runs.
+     */
+    void addAll(const PositionStore &store);
+    /**
+     * Merges every entry of another builder, e.g. one filled by another thread.
+     */
+    void addAll(const PositionStoreBuilder &other);
+    size_t size() const;
+    /**
+     * Writes all positions, sorted, to path.
+     * @param entriesPerBlock Positions per compressed block. Smaller blocks make lookups
+     * cheaper and the sparse index larger.
+     * @return False on I/O failure.
+     */
+    bool write(const std::string &path, int entriesPerBlock = 128) const;
+
+private:
+    struct KeyHash {
+        size_t operator()(const PositionKey &key) const;
+    };
+
+    std::unordered_map<PositionKey, PositionMeta, KeyHash> m_entries;
+};
+
+/**
+ * Read-only, memory-mapped view of a position file.
+ *
+ * File layout (little-endian):
+ *   [header : 40 bytes]  magic, version, entry count, block count, entries per block, index offset
+ *   [blocks]             per entry: varint player delta, varint opponent delta (or xor when the
+ *                        player bits changed), int8 score, uint8 best move, varint visits.
+ *                        Deltas are relative to the previous entry, or to the block's first key.
+ *   [index  : 32 bytes per block]  first key of the block, block offset, entry count, byte size.
+ *
+ * A lookup binary-searches the sparse index and decodes a single block. Lookups do not modify
+ * the store and are safe to run from multiple threads.
+ */
+class PositionStore {
+public:
+    explicit PositionStore(const std::string &path);
+    ~PositionStore();
+
+    PositionStore(const PositionStore &) = delete;
+    PositionStore &operator=(const PositionStore &) = delete;
+
+    bool isOpen() const;
+    uint64_t size() const;
+    /**
+     * Looks up a position in any orientation.
+     * @param player Bits of the side to move.
+     * @param opponent Bits of the other side.
+     * @param meta Set to the stored data, with the best move mapped into the frame of the query.
+     * @return True if the position is stored.
+     */
+    bool lookup(uint64_t player, uint64_t opponent, PositionMeta &meta) const;
+    /**
+     * Visits every stored (canonical) position in sorted order.
+     */
+    void forEach(const std::function<void(const PositionKey &, const PositionMeta &)> &callback) const;
+
+    static const uint32_t MAGIC = 0x3153504F; // "OPS1"
+    static const uint32_t VERSION = 1;
+    static const size_t HEADER_SIZE = 40;
+    static const size_t INDEX_ENTRY_SIZE = 32;
+
+private:
+    const uint8_t *m_data;
+    size_t m_size;
+    uint64_t m_entryCount;
+    uint32_t m_blockCount;
+    const uint8_t *m_index;
+
+    PositionKey blockKey(uint32_t block) const;
+    /**
+     * Decodes block entries in order, stopping early when the callback returns false.
+     */
+    void scanBlock(uint32_t block, const std::function<bool(const PositionKey &, const PositionMeta &)> &callback) const;
+};
+
+#endif //OTHELLOPROJECT_CPP_POSITIONSTORE_H
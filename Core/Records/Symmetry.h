@@ -0,0 +1,145 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_SYMMETRY_H
+#define OTHELLOPROJECT_CPP_SYMMETRY_H
+
+#include <cstdint>
+
+#include "../Bits.h"
+
+// Number of symmetries of the board (the dihedral group of the square).
+#define SYMMETRY_COUNT 8
+
+/**
+ * Board symmetry transforms on the BitBoard layout (H8 = bit 0, A1 = bit 63, one byte per row).
+ *
+ * Every symmetry is encoded as a 3-bit index: bit 0 = flip rows, bit 1 = mirror columns,
+ * bit 2 = transpose. Transposition is applied first, so transform(b, s) for s in [0, 8)
+ * enumerates all eight images of the board exactly once.
+ */
+class Symmetry {
+public:
+    /**
+     * Flips the board upside down (row 1 <-> row 8).
+     */
+    static inline uint64_t flipVertical(uint64_t b) {
+        return __builtin_bswap64(b);
+    }
+
+    /**
+     * Mirrors the board left to right (column A <-> column H).
+     */
+    static inline uint64_t mirrorHorizontal(uint64_t b) {
+        const uint64_t k1 = 0x5555555555555555ULL;
+        const uint64_t k2 = 0x3333333333333333ULL;
+        const uint64_t k4 = 0x0f0f0f0f0f0f0f0fULL;
+        b = ((b >> 1) & k1) | ((b & k1) << 1);
+        b = ((b >> 2) & k2) | ((b & k2) << 2);
+        b = ((b >> 4) & k4) | ((b & k4) << 4);
+        return b;
+    }
+
+    /**
+     * Transposes the board about the H8-A1 diagonal.
+     */
+    static inline uint64_t transpose(uint64_t b) {
+        uint64_t t;
+        const uint64_t k1 = 0x5500550055005500ULL;
+        const uint64_t k2 = 0x3333000033330000ULL;
+        const uint64_t k4 = 0x0f0f0f0f00000000ULL;
+        t = k4 & (b ^ (b << 28));
+        b ^= t ^ (t >> 28);
+        t = k2 & (b ^ (b << 14));
+        b ^= t ^ (t >> 14);
+        t = k1 & (b ^ (b << 7));
+        b ^= t ^ (t >> 7);
+        return b;
+    }
+
+    /**
+     * Applies symmetry s (see class comment) to the bits.
+     */
+    static inline uint64_t transform(uint64_t b, int s) {
+        if(s & 4) {
+            b = transpose(b);
+        }
+        if(s & 1) {
+            b = flipVertical(b);
+        }
+        if(s & 2) {
+            b = mirrorHorizontal(b);
+        }
+        return b;
+    }
+
+    /**
+     * Undoes symmetry s, so that inverse(transform(b, s), s) == b.
+     */
+    static inline uint64_t inverse(uint64_t b, int s) {
+        if(s & 2) {
+            b = mirrorHorizontal(b);
+        }
+        if(s & 1) {
+            b = flipVertical(b);
+        }
+        if(s & 4) {
+            b = transpose(b);
+        }
+        return b;
+    }
+
+    /**
+     * Maps a board position (0-63) through symmetry s. Positions outside the board (passes) are returned as-is.
+     */
+    static inline int transformPos(int pos, int s) {
+        if(pos < 0 || pos > 63) {
+            return pos;
+        }
+        return Bits::lowest(transform(1ULL << pos, s));
+    }
+
+    /**
+     * Maps a position produced by transformPos back to the original frame.
+     */
+    static inline int inversePos(int pos, int s) {
+        if(pos < 0 || pos > 63) {
+            return pos;
+        }
+        return Bits::lowest(inverse(1ULL << pos, s));
+    }
+
+    /**
+     * Finds the canonical image of a position: the lexicographically smallest (player, opponent)
+     * pair over all eight symmetries.
+     * @param player Bits of the side to move. Replaced with the canonical bits.
+     * @param opponent Bits of the other side. Replaced with the canonical bits.
+     * @return The symmetry that maps the original position onto the canonical one.
+     */
+    static inline int canonicalize(uint64_t &player, uint64_t &opponent) {
+        uint64_t bestP = player;
+        uint64_t bestO = opponent;
+        int best = 0;
+
+        for(int s = 1; s < SYMMETRY_COUNT; s++) {
+            uint64_t p = transform(player, s);
+            if(p > bestP) {
+                continue;
+            }
+
+            uint64_t o = transform(opponent, s);
+            if(p < bestP || o < bestO) {
+                bestP = p;
+                bestO = o;
+                best = s;
+            }
+        }
+
+        player = bestP;
+        opponent = bestO;
+        return best;
+    }
+};
+
+#endif //OTHELLOPROJECT_CPP_SYMMETRY_H
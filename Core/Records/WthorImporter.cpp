@@ -0,0 +1,358 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "WthorImporter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ByteIO.h"
+#include "GameRecordWriter.h"
+#include "PositionStore.h"
+#include "../Bits.h"
+#include "../Logger.h"
+#include "../OthelloGame/Color.h"
+#include "../OthelloGame/OthelloGameBoard.h"
+
+namespace {
+
+// Header fields.
+const size_t W_GAME_COUNT = 4;
+const size_t W_YEAR = 10;
+const size_t W_BOARD_SIZE = 12;
+const size_t W_SCORE_DEPTH = 14;
+
+// Game fields.
+const size_t G_BLACK_DISCS = 6;
+const size_t G_THEORETICAL = 7;
+const size_t G_MOVES = 8;
+
+/**
+ * Everything imported from one file, merged into the totals in file order.
+ */
+struct FileImport {
+    WthorImportResult result;
+    std::vector<GameRecord> records;
+};
+
+// Seconds since the epoch at the start of the year, for GameRecord::timestamp.
+uint32_t yearStart(int year) {
+    int64_t days = 0;
+    for(int y = 1970; y < year; y++) {
+        days += (y % 4 == 0 && (y % 100 != 0 || y % 400 == 0)) ? 366 : 365;
+    }
+    return days < 0 ? 0 : (uint32_t) (days * 86400);
+}
+
+void importFile(const std::string &path, const WthorImportOptions &options, FileImport &out,
+                PositionStoreBuilder *positions) {
+    WthorImportResult &result = out.result;
+    result.files = 1;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        result.badFiles = 1;
+        return;
+    }
+
+    struct stat st{};
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    if(fstat(fd, &st) == 0 && (size_t) st.st_size >= WthorImporter::HEADER_SIZE) {
+        void *mapped = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapped != MAP_FAILED) {
+            madvise(mapped, (size_t) st.st_size, MADV_SEQUENTIAL);
+            data = (const uint8_t *) mapped;
+            size = (size_t) st.st_size;
+        }
+    }
+    close(fd);
+
+    // Board size 0 also means 8x8 in older archives.
+    if(data == nullptr || (data[W_BOARD_SIZE] != 0 && data[W_BOARD_SIZE] != 8)) {
+        result.badFiles = 1;
+        if(data != nullptr) {
+            munmap((void *) data, size);
+        }
+        return;
+    }
+    result.bytes = size;
+
+    // A truncated file still yields its complete games.
+    uint64_t count = std::min<uint64_t>(ByteIO::getU32(data + W_GAME_COUNT),
+                                        (size - WthorImporter::HEADER_SIZE) / WthorImporter::GAME_SIZE);
+    uint32_t timestamp = yearStart(ByteIO::getU16(data + W_YEAR));
+    int scoreDepth = data[W_SCORE_DEPTH];
+
+    WthorGame game;
+    for(uint64_t i = 0; i < count; i++) {
+        const uint8_t *raw = data + WthorImporter::HEADER_SIZE + i * WthorImporter::GAME_SIZE;
+        result.games++;
+
+        if(!WthorImporter::replay(raw, game)) {
+            result.illegalGames++;
+            continue;
+        }
+
+        // Archives count empty squares for the winner.
+        int black = game.blackDiscs, white = game.whiteDiscs;
+        int empties = 64 - black - white;
+        int blackScore = black > white ? black + empties : black < white ? black : black + empties / 2;
+        if(blackScore != raw[G_BLACK_DISCS]) {
+            result.scoreMismatches++;
+        }
+        (black > white ? result.blackWins : black < white ? result.whiteWins : result.draws)++;
+
+        for(int ply = 0; ply < game.plies; ply++) {
+            if(game.moves[ply] == RECORD_PASS) {
+                result.passes++;
+            } else {
+                result.positions++;
+                result.squareCounts[game.moves[ply]]++;
+            }
+        }
+
+        if(positions != nullptr) {
+            for(int ply = 0; ply < game.plies && ply <= options.maxPositionPly; ply++) {
+                if(game.moves[ply] == RECORD_PASS) {
+                    continue;
+                }
+
+                PositionMeta meta;
+                meta.visits = 1;
+                // The perfect-play score holds from the first position with scoreDepth empties.
+                int plyEmpties = 64 - Bits::popcount(game.player[ply] | game.opponent[ply]);
+                if(scoreDepth > 0 && plyEmpties == scoreDepth) {
+                    int blackDiff = 2 * raw[G_THEORETICAL] - 64;
+                    bool blackToMove = (ply % 2 == 0);
+                    meta.solvedScore = (int8_t) (blackToMove ? blackDiff : -blackDiff);
+                    result.solvedPositions++;
+                }
+                positions->add(game.player[ply], game.opponent[ply], meta);
+            }
+        }
+
+        if(!options.recordDir.empty()) {
+            GameRecord record;
+            record.blackDiscs = (uint8_t) black;
+            record.whiteDiscs = (uint8_t) white;
+            record.timestamp = timestamp;
+            record.moves.assign(game.moves, game.moves + game.plies);
+            out.records.push_back(std::move(record));
+        }
+    }
+
+    munmap((void *) data, size);
+}
+
+void addResult(WthorImportResult &total, const WthorImportResult &file) {
+    total.files += file.files;
+    total.badFiles += file.badFiles;
+    total.bytes += file.bytes;
+    total.games += file.games;
+    total.illegalGames += file.illegalGames;
+    total.scoreMismatches += file.scoreMismatches;
+    total.positions += file.positions;
+    total.passes += file.passes;
+    for(int i = 0; i < 64; i++) {
+        total.squareCounts[i] += file.squareCounts[i];
+    }
+    total.blackWins += file.blackWins;
+    total.whiteWins += file.whiteWins;
+    total.draws += file.draws;
+    total.solvedPositions += file.solvedPositions;
+}
+
+}
+
+bool WthorImporter::replay(const uint8_t *game, WthorGame &out) {
+    uint64_t black = 0x0000000810000000ULL, white = 0x0000001008000000ULL;
+    int color = BLACK;
+    out.plies = 0;
+
+    for(int i = 0; i < 60; i++) {
+        int code = game[G_MOVES + i];
+        if(code == 0) {
+            break;
+        }
+
+        int row = code / 10, col = code % 10;
+        if(row < 1 || row > 8 || col < 1 || col > 8) {
+            return false;
+        }
+        // a1 is bit 63, h8 bit 0.
+        int pos = 63 - ((row - 1) * 8 + (col - 1));
+
+        uint64_t *own = color == BLACK ? &black : &white;
+        uint64_t *other = color == BLACK ? &white : &black;
+        uint64_t legal = OthelloGameBoard::generateMoveMask(*own, *other);
+
+        // Passes are not written down: a side without a move silently hands over.
+        if(legal == 0) {
+            out.player[out.plies] = *own;
+            out.opponent[out.plies] = *other;
+            out.moves[out.plies++] = RECORD_PASS;
+            std::swap(own, other);
+            color = -color;
+            legal = OthelloGameBoard::generateMoveMask(*own, *other);
+        }
+
+        if(((1ULL << pos) & legal) == 0) {
+            return false;
+        }
+
+        out.player[out.plies] = *own;
+        out.opponent[out.plies] = *other;
+        out.moves[out.plies++] = (uint8_t) pos;
+
+        uint64_t flips = OthelloGameBoard::getFlips(*own, *other, pos);
+        *own |= flips | (1ULL << pos);
+        *other &= ~flips;
+        color = -color;
+    }
+
+    out.blackDiscs = Bits::popcount(black);
+    out.whiteDiscs = Bits::popcount(white);
+    return true;
+}
+
+WthorImportResult WthorImporter::run(const std::vector<std::string> &paths, const WthorImportOptions &options) {
+    auto start = std::chrono::steady_clock::now();
+
+    int threads = options.threads > 0 ? options.threads : (int) std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, (int) paths.size()));
+    bool storePositions = !options.positionPath.empty();
+
+    // Each thread fills its own position builder; they are merged once all files are done.
+    std::vector<FileImport> files(paths.size());
+    std::vector<std::unique_ptr<PositionStoreBuilder>> builders;
+    for(int t = 0; t < threads; t++) {
+        builders.push_back(storePositions ? std::make_unique<PositionStoreBuilder>() : nullptr);
+    }
+
+    std::atomic<size_t> next(0);
+    auto worker = [&](int thread) {
+        for(size_t i; (i = next.fetch_add(1)) < paths.size();) {
+            importFile(paths[i], options, files[i], builders[thread].get());
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for(int t = 1; t < threads; t++) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for(std::thread &thread : pool) {
+        thread.join();
+    }
+
+    WthorImportResult total;
+    std::unique_ptr<GameRecordWriter> writer;
+    if(!options.recordDir.empty()) {
+        writer = std::make_unique<GameRecordWriter>(options.recordDir, "wthor");
+    }
+
+    for(size_t i = 0; i < files.size(); i++) {
+        if(files[i].result.badFiles != 0) {
+            Logger::log(LogLevel::Warn, "Skipping " + paths[i] + ": not a readable 8x8 WTHOR archive");
+        }
+        addResult(total, files[i].result);
+
+        if(writer) {
+            for(const GameRecord &record : files[i].records) {
+                if(!writer->append(record)) {
+                    Logger::log(LogLevel::Error, "Could not write records to " + options.recordDir);
+                    break;
+                }
+            }
+            files[i].records.clear();
+            files[i].records.shrink_to_fit();
+        }
+    }
+    if(writer && !writer->flush()) {
+        Logger::log(LogLevel::Error, "Could not write records to " + options.recordDir);
+    }
+
+    if(storePositions) {
+        for(int t = 1; t < threads; t++) {
+            builders[0]->addAll(*builders[t]);
+            builders[t].reset();
+        }
+        total.storedPositions = builders[0]->size();
+        if(!builders[0]->write(options.positionPath)) {
+            Logger::log(LogLevel::Error, "Could not write " + options.positionPath);
+        }
+    }
+
+    total.timeMs = (uint64_t) std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    return total;
+}
+
+void WthorImporter::report(const WthorImportResult &result) {
+    uint64_t perSecond = result.timeMs == 0 ? 0 : result.positions * 1000 / result.timeMs;
+    Logger::writeProtocol("Imported " + std::to_string(result.games - result.illegalGames) + " of " +
+                          std::to_string(result.games) + " games from " +
+                          std::to_string(result.files - result.badFiles) + " files (" +
+                          std::to_string(result.bytes / 1024) + " KiB) in " + std::to_string(result.timeMs) + "ms, " +
+                          std::to_string(result.positions) + " positions, " + std::to_string(perSecond) +
+                          " positions/s");
+    Logger::writeProtocol("Illegal games " + std::to_string(result.illegalGames) + ", score mismatches " +
+                          std::to_string(result.scoreMismatches) + ", passes " + std::to_string(result.passes) +
+                          ", black +" + std::to_string(result.blackWins) + " -" + std::to_string(result.whiteWins) +
+                          " =" + std::to_string(result.draws));
+    if(result.storedPositions != 0) {
+        Logger::writeProtocol("Stored " + std::to_string(result.storedPositions) + " distinct positions, " +
+                              std::to_string(result.solvedPositions) + " with perfect-play scores");
+    }
+
+    // Move frequencies per square, in thousandths of all moves, a1 top left.
+    Logger::writeProtocol("Moves per square (per mille):");
+    Logger::writeProtocol("      a    b    c    d    e    f    g    h");
+    for(int row = 0; row < 8; row++) {
+        std::string line = std::to_string(row + 1) + " ";
+        for(int col = 0; col < 8; col++) {
+            uint64_t count = result.squareCounts[63 - (row * 8 + col)];
+            std::string cell = std::to_string(result.positions == 0 ? 0 : count * 1000 / result.positions);
+            line += std::string(5 - std::min<size_t>(4, cell.length()), ' ') + cell;
+        }
+        Logger::writeProtocol(line);
+    }
+}
+
+std::vector<std::string> WthorImporter::listFiles(const std::string &path) {
+    std::vector<std::string> files;
+    std::stringstream list(path);
+
+    for(std::string item; std::getline(list, item, ',');) {
+        std::error_code ec;
+        if(!std::filesystem::is_directory(item, ec)) {
+            files.push_back(item);
+            continue;
+        }
+
+        std::vector<std::string> found;
+        for(const auto &entry : std::filesystem::directory_iterator(item, ec)) {
+            std::string extension = entry.path().extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+            if(entry.is_regular_file() && extension == ".wtb") {
+                found.push_back(entry.path().string());
+            }
+        }
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    }
+
+    return files;
+}
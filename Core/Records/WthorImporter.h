@@ -0,0 +1,129 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_WTHORIMPORTER_H
+#define OTHELLOPROJECT_CPP_WTHORIMPORTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GameRecord.h"
+
+struct WthorImportOptions {
+    /**
+     * Files imported at once, 0 for one per core.
+     */
+    int threads = 0;
+    /**
+     * Directory for the imported games as GameRecords (see GameRecordWriter), empty for none.
+     */
+    std::string recordDir;
+    /**
+     * Path of a PositionStore to write every position to, empty for none.
+     */
+    std::string positionPath;
+    /**
+     * Only positions up to this many plies (passes included) into the game are stored.
+     */
+    int maxPositionPly = 60;
+};
+
+struct WthorImportResult {
+    int files = 0;
+    /**
+     * Files that could not be read or do not hold 8x8 games.
+     */
+    int badFiles = 0;
+    uint64_t bytes = 0;
+    uint64_t games = 0;
+    /**
+     * Games with a move that is not legal for the side to move. Dropped from every output.
+     */
+    uint64_t illegalGames = 0;
+    /**
+     * Games whose final disc count differs from the one in the archive. Still imported.
+     */
+    uint64_t scoreMismatches = 0;
+    /**
+     * Positions replayed, passes not counted.
+     */
+    uint64_t positions = 0;
+    uint64_t passes = 0;
+    /**
+     * How often each board position was played.
+     */
+    uint64_t squareCounts[64] = {};
+    uint64_t blackWins = 0;
+    uint64_t whiteWins = 0;
+    uint64_t draws = 0;
+    /**
+     * Distinct positions written to the position store, over the eight symmetries.
+     */
+    uint64_t storedPositions = 0;
+    /**
+     * Positions given the archive's perfect-play score, at its theoretical score depth.
+     */
+    uint64_t solvedPositions = 0;
+    uint64_t timeMs = 0;
+};
+
+// Plies in a game, passes included: 60 moves and at most one pass before each.
+#define WTHOR_MAX_PLIES 120
+
+/**
+ * A replayed WTHOR game.
+ */
+struct WthorGame {
+    int plies = 0;
+    /**
+     * Board position of every ply, or RECORD_PASS.
+     */
+    uint8_t moves[WTHOR_MAX_PLIES];
+    /**
+     * Discs of the side to move and of the other side before every ply.
+     */
+    uint64_t player[WTHOR_MAX_PLIES];
+    uint64_t opponent[WTHOR_MAX_PLIES];
+    int blackDiscs = 0;
+    int whiteDiscs = 0;
+};
+
+/**
+ * Importer for WTHOR game archives (*.wtb), the French federation's format used by most
+ * Othello databases.
+ *
+ * File layout (little-endian): a 16-byte header (creation date, uint32 game count at offset 4,
+ * uint16 year at 10, board size at 12, theoretical score depth at 14), then 68 bytes per game:
+ * uint16 tournament, black and white player numbers, uint8 black discs at the end, uint8 black
+ * discs with perfect play from the theoretical score depth, and 60 moves written as
+ * 10 * row + column (11 = a1, 88 = h8), 0 after the last. Passes are implicit.
+ *
+ * Files are memory-mapped and scanned sequentially; every game is replayed with
+ * generateMoveMask and getFlips, so that each move is checked for legality and explicit passes
+ * can be inserted. Files are imported in parallel, and outputs are merged in file order.
+ */
+class WthorImporter {
+public:
+    static const size_t HEADER_SIZE = 16;
+    static const size_t GAME_SIZE = 68;
+
+    /**
+     * @param paths Archive files, in the order their games are written out.
+     */
+    static WthorImportResult run(const std::vector<std::string> &paths, const WthorImportOptions &options);
+    static void report(const WthorImportResult &result);
+    /**
+     * @param path An archive, a directory (all *.wtb files in it, by name) or a comma-separated list of either.
+     */
+    static std::vector<std::string> listFiles(const std::string &path);
+    /**
+     * Replays one 68-byte game.
+     * @return False if a move is not legal for the side to move.
+     */
+    static bool replay(const uint8_t *game, WthorGame &out);
+};
+
+#endif //OTHELLOPROJECT_CPP_WTHORIMPORTER_H
@@ -0,0 +1,292 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "DfpnSolver.h"
+
+#include <algorithm>
+
+#include "Zobrist.h"
+#include "../Bits.h"
+#include "../OthelloGame/OthelloGameBoard.h"
+
+// Proof and disproof numbers: INF for proven / disproven, sums saturate one below it.
+#define DFPN_INF 0xFFFFFFFFu
+#define DFPN_MAX (DFPN_INF - 1)
+
+#define DFPN_BUCKET_SIZE 4
+// A collection starts once this many per mille of the table is in use.
+#define DFPN_COLLECT_FILL 900
+// The deadline is checked every (DFPN_POLL_MASK + 1) nodes.
+#define DFPN_POLL_MASK 1023
+// Positions are at most 33 moves wide; a pass is one child.
+#define DFPN_MAX_CHILDREN 64
+
+// Added to the key of positions whose side to move must end at least one disc ahead rather than level.
+#define DFPN_GOAL_KEY 0x9E3779B97F4A7C15ULL
+
+struct DfpnSolver::Entry {
+    uint64_t key;
+    uint32_t phi;
+    uint32_t delta;
+    /**
+     * Positions expanded below this one so far. 0 for an empty slot.
+     */
+    uint64_t work;
+};
+
+struct DfpnSolver::Node {
+    uint64_t player;   // Side to move
+    uint64_t opponent;
+    uint64_t key;      // Zobrist::compute(player, opponent)
+    uint64_t otherKey; // Zobrist::compute(opponent, player)
+    /**
+     * The side to move has to end at least goal discs ahead, 1 to win and 0 to draw.
+     */
+    int goal;
+    uint32_t phi;
+    uint32_t delta;
+
+    inline uint64_t tableKey() const {
+        return key ^ (goal != 0 ? DFPN_GOAL_KEY : 0);
+    }
+
+    // A finished game is proven or disproven by its disc count.
+    inline void setTerminal() {
+        bool proven = Bits::popcount(player) - Bits::popcount(opponent) >= goal;
+        phi = proven ? 0 : DFPN_INF;
+        delta = proven ? DFPN_INF : 0;
+    }
+};
+
+DfpnSolver::DfpnSolver(size_t megabytes) : m_bucketMask(0), m_used(0), m_collections(0), m_ctx(nullptr),
+                                           m_aborted(false) {
+    size_t buckets = 1;
+    while(buckets * 2 * DFPN_BUCKET_SIZE * sizeof(Entry) <= megabytes * 1024 * 1024) {
+        buckets *= 2;
+    }
+    m_entries = std::unique_ptr<Entry[]>(new Entry[buckets * DFPN_BUCKET_SIZE]);
+    m_bucketMask = buckets - 1;
+    this->clear();
+}
+
+DfpnSolver::~DfpnSolver() = default;
+
+size_t DfpnSolver::getCapacity() const {
+    return (m_bucketMask + 1) * DFPN_BUCKET_SIZE;
+}
+
+const char *DfpnSolver::getOutcomeName(DfpnOutcome outcome) {
+    switch(outcome) {
+        case DfpnOutcome::Win:
+            return "win";
+        case DfpnOutcome::Draw:
+            return "draw";
+        case DfpnOutcome::Loss:
+            return "loss";
+        default:
+            return "unknown";
+    }
+}
+
+void DfpnSolver::clear() {
+    std::fill(m_entries.get(), m_entries.get() + this->getCapacity(), Entry{ 0, 0, 0, 0 });
+    m_used = 0;
+}
+
+DfpnResult DfpnSolver::solve(uint64_t player, uint64_t opponent, SearchContext::Clock::time_point deadline,
+                             SearchContext &ctx) {
+    DfpnResult result;
+    m_ctx = &ctx;
+    m_deadline = deadline;
+    m_aborted = false;
+    m_collections = 0;
+    uint64_t nodesBefore = ctx.getNodes();
+    SearchContext::Clock::time_point start = SearchContext::now();
+
+    // Entries hold facts about a position and a goal, whatever the root, so both proofs share them
+    // and so do later calls.
+    int move = -1;
+    int win = this->prove(player, opponent, 1, move);
+    if(win == 1) {
+        result.outcome = DfpnOutcome::Win;
+        result.move = move;
+    } else if(win == 0) {
+        int draw = this->prove(player, opponent, 0, move);
+        if(draw >= 0) {
+            result.outcome = draw == 1 ? DfpnOutcome::Draw : DfpnOutcome::Loss;
+            result.move = draw == 1 ? move : -1;
+        }
+    }
+
+    result.nodes = ctx.getNodes() - nodesBefore;
+    result.timeMs = (uint64_t) std::chrono::duration_cast<std::chrono::milliseconds>(SearchContext::now() - start).count();
+    result.collections = m_collections;
+    result.usage = (int) (m_used * 1000 / this->getCapacity());
+    m_ctx = nullptr;
+    return result;
+}
+
+int DfpnSolver::prove(uint64_t player, uint64_t opponent, int goal, int &move) {
+    Node root = { player, opponent, Zobrist::compute(player, opponent), Zobrist::compute(opponent, player), goal, 0, 0 };
+    this->lookup(root);
+
+    // Returns once the root is proven or disproven; its numbers never reach DFPN_INF otherwise.
+    move = -1;
+    this->mid(root, DFPN_INF, DFPN_INF, &move);
+    if(m_aborted) {
+        return -1;
+    }
+    return root.phi == 0 ? 1 : 0;
+}
+
+BITS_DISPATCH uint64_t DfpnSolver::mid(Node &node, uint32_t thPhi, uint32_t thDelta, int *bestMove) {
+    if(this->shouldStop()) {
+        return 0;
+    }
+
+    Node children[DFPN_MAX_CHILDREN];
+    int moves[DFPN_MAX_CHILDREN];
+    int count = 0;
+
+    uint64_t legal = OthelloGameBoard::generateMoveMask(node.player, node.opponent);
+    if(legal == 0) {
+        if(OthelloGameBoard::generateMoveMask(node.opponent, node.player) == 0) {
+            node.setTerminal();
+            this->store(node, 1);
+            return 1;
+        }
+        // A forced pass: the only child is the same position with the other side to move.
+        children[0] = { node.opponent, node.player, node.otherKey, node.key, 1 - node.goal, 0, 0 };
+        moves[0] = -1;
+        count = 1;
+    }
+
+    for(; legal != 0; legal = Bits::clearLowest(legal)) {
+        int pos = Bits::lowest(legal);
+        uint64_t flips = OthelloGameBoard::getFlips(node.player, node.opponent, pos);
+        Node &child = children[count];
+        child.player = node.opponent & ~flips;
+        child.opponent = node.player | flips | (1ULL << pos);
+        child.key = node.otherKey ^ Zobrist::moveDelta(1, pos, flips);
+        child.otherKey = node.key ^ Zobrist::moveDelta(0, pos, flips);
+        child.goal = 1 - node.goal;
+        moves[count++] = pos;
+    }
+
+    for(int i = 0; i < count; i++) {
+        this->lookup(children[i]);
+    }
+
+    uint64_t work = 1;
+    int best = 0;
+    while(true) {
+        // The side to move proves its goal through any child whose side to move fails, and fails
+        // only if every child succeeds.
+        uint32_t phi = DFPN_INF;
+        uint64_t delta = 0;
+        uint32_t secondDelta = DFPN_INF;
+        for(int i = 0; i < count; i++) {
+            if(children[i].delta < phi) {
+                secondDelta = phi;
+                phi = children[i].delta;
+                best = i;
+            } else if(children[i].delta < secondDelta) {
+                secondDelta = children[i].delta;
+            }
+            delta += children[i].phi;
+        }
+        // Only a disproven child (delta 0, phi DFPN_INF) proves the node; other sums saturate below DFPN_INF.
+        node.phi = phi;
+        node.delta = phi == 0 ? DFPN_INF : (uint32_t) std::min<uint64_t>(delta, DFPN_MAX);
+
+        if(node.phi >= thPhi || node.delta >= thDelta) {
+            break;
+        }
+
+        // Into the most proving child, until another child is cheaper or the node's own
+        // thresholds would be reached.
+        Node &child = children[best];
+        uint64_t childThPhi = (uint64_t) thDelta - node.delta + child.phi;
+        uint32_t childThDelta = std::min(thPhi, secondDelta == DFPN_INF ? DFPN_INF : secondDelta + 1);
+        work += this->mid(child, (uint32_t) std::min<uint64_t>(childThPhi, DFPN_INF), childThDelta, nullptr);
+        if(m_aborted) {
+            return work;
+        }
+    }
+
+    if(bestMove != nullptr && node.phi == 0) {
+        *bestMove = moves[best];
+    }
+    this->store(node, work);
+    return work;
+}
+
+void DfpnSolver::lookup(Node &node) const {
+    const Entry *bucket = m_entries.get() + (node.tableKey() & m_bucketMask) * DFPN_BUCKET_SIZE;
+    for(int i = 0; i < DFPN_BUCKET_SIZE; i++) {
+        if(bucket[i].work != 0 && bucket[i].key == node.tableKey()) {
+            node.phi = bucket[i].phi;
+            node.delta = bucket[i].delta;
+            return;
+        }
+    }
+
+    uint64_t legal = OthelloGameBoard::generateMoveMask(node.player, node.opponent);
+    if(legal == 0 && OthelloGameBoard::generateMoveMask(node.opponent, node.player) == 0) {
+        node.setTerminal();
+        return;
+    }
+    node.phi = 1;
+    node.delta = legal == 0 ? 1 : (uint32_t) Bits::popcount(legal);
+}
+
+void DfpnSolver::store(const Node &node, uint64_t work) {
+    uint64_t key = node.tableKey();
+    Entry *bucket = m_entries.get() + (key & m_bucketMask) * DFPN_BUCKET_SIZE;
+
+    Entry *target = nullptr;
+    for(int i = 0; i < DFPN_BUCKET_SIZE; i++) {
+        if(bucket[i].work != 0 && bucket[i].key == key) {
+            bucket[i].phi = node.phi;
+            bucket[i].delta = node.delta;
+            bucket[i].work += work;
+            return;
+        }
+        if(target == nullptr || bucket[i].work < target->work) {
+            target = &bucket[i];
+        }
+    }
+
+    if(target->work == 0) {
+        if(m_used * 1000 >= this->getCapacity() * DFPN_COLLECT_FILL) {
+            this->collect();
+        }
+        m_used++;
+    }
+    *target = { key, node.phi, node.delta, work };
+}
+
+void DfpnSolver::collect() {
+    m_collections++;
+    size_t capacity = this->getCapacity();
+    for(uint64_t threshold = 1; m_used > capacity / 2; threshold *= 2) {
+        for(size_t i = 0; i < capacity; i++) {
+            if(m_entries[i].work != 0 && m_entries[i].work <= threshold) {
+                m_entries[i].work = 0;
+                m_used--;
+            }
+        }
+    }
+}
+
+bool DfpnSolver::shouldStop() {
+    if(m_aborted) {
+        return true;
+    }
+    if(m_ctx->shouldStop() ||
+       ((m_ctx->getNodes() & DFPN_POLL_MASK) == 0 && SearchContext::now() >= m_deadline)) {
+        m_aborted = true;
+    }
+    return m_aborted;
+}
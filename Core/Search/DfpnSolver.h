@@ -0,0 +1,131 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_DFPNSOLVER_H
+#define OTHELLOPROJECT_CPP_DFPNSOLVER_H
+
+#include <cstdint>
+#include <memory>
+
+#include "SearchContext.h"
+
+// Default table size, in megabytes.
+#define DFPN_DEFAULT_MB 16
+
+/**
+ * Game-theoretic value of a position for the side to move.
+ */
+enum class DfpnOutcome {
+    /**
+     * Not proven before the deadline or a stop.
+     */
+    Unknown,
+    Win,
+    Draw,
+    Loss
+};
+
+/**
+ * Result of the most recent DfpnSolver::solve call.
+ */
+struct DfpnResult {
+    DfpnOutcome outcome = DfpnOutcome::Unknown;
+    /**
+     * A move that achieves a win or a draw, -1 for a loss, an unknown outcome or a forced pass.
+     */
+    int move = -1;
+    uint64_t nodes = 0;
+    uint64_t timeMs = 0;
+    /**
+     * Table garbage collections, and the table's fill in per mille when the search ended.
+     */
+    int collections = 0;
+    int usage = 0;
+};
+
+/**
+ * Depth-first proof-number search (df-pn) for proving wins, draws and losses in the endgame.
+ *
+ * An outcome is two boolean proofs: "the side to move ends with more discs" and, if that fails,
+ * "the side to move ends with at least as many discs". Each is searched in negamax form, where a
+ * node's proof number phi is the cost of proving the goal for its side to move and delta the cost
+ * of disproving it: phi is the smallest delta among the children and delta the sum of the
+ * children's phi. The search always descends into the most proving child, with thresholds that send
+ * it back up as soon as another child becomes cheaper. A position that is not yet in the table gets
+ * phi 1 and delta equal to its mobility, since a side with many moves is hard to refute.
+ *
+ * Proof and disproof numbers are kept in a bounded table. Once it is nearly full, entries whose
+ * subtrees took the least work to search are dropped until it is half empty again, so the search
+ * runs in a fixed amount of memory for as long as it needs to.
+ *
+ * Not thread-safe: a solver is used by one search at a time.
+ */
+class DfpnSolver {
+public:
+    /**
+     * Allocates an empty table of at most megabytes (rounded down to a power of two buckets).
+     */
+    explicit DfpnSolver(size_t megabytes = DFPN_DEFAULT_MB);
+    ~DfpnSolver();
+
+    DfpnSolver(const DfpnSolver &) = delete;
+    DfpnSolver &operator=(const DfpnSolver &) = delete;
+
+    /**
+     * Proves the outcome of a position, until the deadline passes or ctx is stopped. Every node is
+     * counted in ctx.
+     * @param player Bits of the side to move.
+     * @param opponent Bits of the other side.
+     */
+    DfpnResult solve(uint64_t player, uint64_t opponent, SearchContext::Clock::time_point deadline, SearchContext &ctx);
+
+    /**
+     * @return Number of positions the table can hold.
+     */
+    size_t getCapacity() const;
+    /**
+     * Empties the table. Entries stay valid from one solve to the next, so this is only needed to
+     * measure a solve on its own.
+     */
+    void clear();
+    static const char *getOutcomeName(DfpnOutcome outcome);
+
+private:
+    struct Entry;
+    struct Node;
+
+    std::unique_ptr<Entry[]> m_entries;
+    size_t m_bucketMask;
+    size_t m_used;
+    int m_collections;
+
+    SearchContext *m_ctx;
+    SearchContext::Clock::time_point m_deadline;
+    bool m_aborted;
+
+    /**
+     * Proves or disproves "the side to move ends at least goal discs ahead" for the root.
+     * @param move Set to the move that proves it.
+     * @return 1 if proven, 0 if disproven, -1 if aborted.
+     */
+    int prove(uint64_t player, uint64_t opponent, int goal, int &move);
+    /**
+     * Searches below node until its phi reaches thPhi or its delta reaches thDelta.
+     * @param bestMove If not null, set to the move that proves the node once it is proven.
+     * @return Positions expanded, the work stored with the node.
+     */
+    uint64_t mid(Node &node, uint32_t thPhi, uint32_t thDelta, int *bestMove);
+    /**
+     * Fills in a node's numbers from the table, or from the position itself if it is not stored.
+     */
+    void lookup(Node &node) const;
+    void store(const Node &node, uint64_t work);
+    /**
+     * Drops the entries with the least work until the table is at most half full.
+     */
+    void collect();
+    bool shouldStop();
+};
+
+#endif //OTHELLOPROJECT_CPP_DFPNSOLVER_H
@@ -0,0 +1,382 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "Mcts.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "../Bits.h"
+#include "../Trace.h"
+#include "../Logger.h"
+#include "../PerfCounters.h"
+#include "../OthelloGame/OthelloGameBoard.h"
+
+// Node states
+#define NODE_LEAF 0
+#define NODE_EXPANDING 1
+#define NODE_EXPANDED 2
+#define NODE_TERMINAL 3
+
+// Move value used for pass edges.
+#define MCTS_PASS 64
+
+// UCT exploration constant.
+#define MCTS_UCT_C 0.8
+// Visits added (as losses) to every node on a thread's path while its playout is in flight.
+#define MCTS_VIRTUAL_LOSS 3
+// A leaf is expanded once it has been visited this many times.
+#define MCTS_EXPAND_VISITS 2
+// Longest possible tree path: 60 moves plus passes.
+#define MCTS_MAX_PATH 128
+// Workers check the clock every (MCTS_POLL_MASK + 1) playouts.
+#define MCTS_POLL_MASK 63
+
+#define MCTS_CORNERS 0x8100000000000081ULL
+#define MCTS_X_SQUARES 0x0042000000004200ULL
+
+struct Mcts::Node {
+    uint64_t player;   // Side to move
+    uint64_t opponent;
+    std::atomic<int64_t> wins; // Half points (win = 2, draw = 1) for the side that moved into this node
+    std::atomic<int32_t> visits;
+    std::atomic<int32_t> virtualLoss;
+    std::atomic<uint32_t> firstChild;
+    std::atomic<uint8_t> state;
+    uint8_t childCount;
+    uint8_t move;
+};
+
+namespace {
+
+inline uint64_t nextRandom(uint64_t &state) {
+    // xorshift64*
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * Light playout policy: always take a corner if one is available, and avoid X-squares most of the time.
+ */
+inline int pickMove(uint64_t moves, uint64_t &rng) {
+    uint64_t corners = moves & MCTS_CORNERS;
+    uint64_t r = nextRandom(rng);
+
+    if(corners != 0) {
+        moves = corners;
+    } else {
+        uint64_t safe = moves & ~MCTS_X_SQUARES;
+        if(safe != 0 && (r & 7) != 0) {
+            moves = safe;
+        }
+    }
+
+    int k = (int) ((r >> 8) % (uint64_t) Bits::popcount(moves));
+    while(k-- > 0) {
+        moves = Bits::clearLowest(moves);
+    }
+    return Bits::lowest(moves);
+}
+
+/**
+ * Plays random moves to the end of the game.
+ * @return 2 for a win, 1 for a draw, 0 for a loss, from the point of view of the side to move.
+ */
+int playout(uint64_t player, uint64_t opponent, uint64_t &rng) {
+    bool swapped = false;
+
+    while(true) {
+        uint64_t moves = OthelloGameBoard::generateMoveMask(player, opponent);
+        if(moves == 0) {
+            if(OthelloGameBoard::generateMoveMask(opponent, player) == 0) {
+                break;
+            }
+        } else {
+            int pos = pickMove(moves, rng);
+            uint64_t flips = OthelloGameBoard::getFlips(player, opponent, pos);
+            player |= flips | (1ULL << pos);
+            opponent &= ~flips;
+        }
+
+        std::swap(player, opponent);
+        swapped = !swapped;
+    }
+
+    int diff = Bits::popcount(player) - Bits::popcount(opponent);
+    if(swapped) {
+        diff = -diff;
+    }
+    return diff > 0 ? 2 : (diff == 0 ? 1 : 0);
+}
+
+}
+
+double MctsStats::getPlayoutsPerSecond() const {
+    return this->timeMs == 0 ? 0.0 : this->playouts * 1000.0 / this->timeMs;
+}
+
+Mcts::Mcts(size_t maxNodes, int threads) : m_nodes(new Node[maxNodes < 2 ? 2 : maxNodes]),
+                                           m_capacity(maxNodes < 2 ? 2 : maxNodes), m_used(0), m_threads(threads) {
+    if(m_threads <= 0) {
+        m_threads = (int) std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+Mcts::~Mcts() = default;
+
+const MctsStats &Mcts::getLastStats() const {
+    return m_lastStats;
+}
+
+const SearchInfo &Mcts::getLastSearchInfo() const {
+    return m_lastSearch;
+}
+
+uint32_t Mcts::allocate(int count) {
+    // Checked first so that failed claims on a full arena cannot wrap the counter around.
+    if(m_used.load(std::memory_order_relaxed) >= m_capacity) {
+        return 0;
+    }
+
+    uint32_t first = m_used.fetch_add((uint32_t) count, std::memory_order_relaxed);
+    if(first + (size_t) count > m_capacity) {
+        return 0;
+    }
+    return first;
+}
+
+void Mcts::initNode(Node &node, uint64_t player, uint64_t opponent, int move) {
+    node.player = player;
+    node.opponent = opponent;
+    node.wins.store(0, std::memory_order_relaxed);
+    node.visits.store(0, std::memory_order_relaxed);
+    node.virtualLoss.store(0, std::memory_order_relaxed);
+    node.firstChild.store(0, std::memory_order_relaxed);
+    node.childCount = 0;
+    node.move = (uint8_t) move;
+    node.state.store(NODE_LEAF, std::memory_order_relaxed);
+}
+
+void Mcts::expand(Node &node) {
+    uint8_t expected = NODE_LEAF;
+    if(!node.state.compare_exchange_strong(expected, NODE_EXPANDING, std::memory_order_acquire)) {
+        return;
+    }
+
+    uint64_t moves = OthelloGameBoard::generateMoveMask(node.player, node.opponent);
+    int count = moves != 0 ? Bits::popcount(moves) : 1;
+
+    if(moves == 0 && OthelloGameBoard::generateMoveMask(node.opponent, node.player) == 0) {
+        node.state.store(NODE_TERMINAL, std::memory_order_release);
+        return;
+    }
+
+    uint32_t first = this->allocate(count);
+    if(first == 0) {
+        // Arena is full; leave the node as a leaf for good.
+        node.state.store(NODE_LEAF, std::memory_order_release);
+        return;
+    }
+
+    if(moves == 0) {
+        // Forced pass: a single child with the sides swapped.
+        this->initNode(m_nodes[first], node.opponent, node.player, MCTS_PASS);
+    } else {
+        uint32_t index = first;
+        for(uint64_t m = moves; m != 0; m = Bits::clearLowest(m)) {
+            int pos = Bits::lowest(m);
+            uint64_t flips = OthelloGameBoard::getFlips(node.player, node.opponent, pos);
+            this->initNode(m_nodes[index++], node.opponent & ~flips, node.player | flips | (1ULL << pos), pos);
+        }
+    }
+
+    node.firstChild.store(first, std::memory_order_relaxed);
+    node.childCount = (uint8_t) count;
+    node.state.store(NODE_EXPANDED, std::memory_order_release);
+}
+
+uint64_t Mcts::worker(int id, SearchContext::Clock::time_point deadline, SearchContext &ctx, int &maxDepth) {
+    uint64_t rng = 0x9E3779B97F4A7C15ULL * (id + 1) ^ (uint64_t) SearchContext::now().time_since_epoch().count();
+    if(rng == 0) {
+        rng = 1;
+    }
+
+    Node *path[MCTS_MAX_PATH];
+    uint64_t playouts = 0;
+    maxDepth = 0;
+
+    while(true) {
+        if((playouts & MCTS_POLL_MASK) == 0) {
+            // The stop callback is only asked from one thread.
+            bool stopped = id == 0 ? ctx.pollStopCallback() : ctx.isStopped();
+            if(stopped || SearchContext::now() >= deadline) {
+                break;
+            }
+        }
+
+        Node *node = &m_nodes[0];
+        int length = 0;
+        path[length++] = node;
+        node->virtualLoss.fetch_add(MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+
+        // Selection
+        while(length < MCTS_MAX_PATH) {
+            uint8_t state = node->state.load(std::memory_order_acquire);
+            if(state == NODE_LEAF && node->visits.load(std::memory_order_relaxed) >= MCTS_EXPAND_VISITS) {
+                this->expand(*node);
+                state = node->state.load(std::memory_order_acquire);
+            }
+            if(state != NODE_EXPANDED) {
+                break;
+            }
+
+            int parentVisits = node->visits.load(std::memory_order_relaxed) +
+                               node->virtualLoss.load(std::memory_order_relaxed);
+            double logParent = std::log((double) std::max(parentVisits, 1));
+
+            Node *children = &m_nodes[node->firstChild.load(std::memory_order_relaxed)];
+            Node *best = &children[0];
+            double bestValue = -1.0;
+
+            for(int i = 0; i < node->childCount; i++) {
+                Node &child = children[i];
+                int n = child.visits.load(std::memory_order_relaxed) + child.virtualLoss.load(std::memory_order_relaxed);
+                if(n == 0) {
+                    best = &child;
+                    break;
+                }
+
+                // Virtual losses count as visits without wins.
+                double q = child.wins.load(std::memory_order_relaxed) / (2.0 * n);
+                double value = q + MCTS_UCT_C * std::sqrt(logParent / n);
+                if(value > bestValue) {
+                    bestValue = value;
+                    best = &child;
+                }
+            }
+
+            node = best;
+            node->virtualLoss.fetch_add(MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+            path[length++] = node;
+        }
+
+        // Simulation
+        int result = playout(node->player, node->opponent, rng);
+        playouts++;
+        maxDepth = std::max(maxDepth, length - 1);
+
+        // Backpropagation. Every edge, passes included, swaps the side to move.
+        int value = 2 - result;
+        for(int i = length - 1; i >= 0; i--) {
+            path[i]->wins.fetch_add(value, std::memory_order_relaxed);
+            path[i]->visits.fetch_add(1, std::memory_order_relaxed);
+            path[i]->virtualLoss.fetch_sub(MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+            value = 2 - value;
+        }
+    }
+
+    return playouts;
+}
+
+int Mcts::search(uint64_t player, uint64_t opponent, SearchContext::Clock::time_point deadline, SearchContext &ctx) {
+    TRACE_SCOPE("mcts search");
+    auto start = SearchContext::now();
+
+    m_used.store(1, std::memory_order_relaxed);
+    this->initNode(m_nodes[0], player, opponent, MCTS_PASS);
+    this->expand(m_nodes[0]);
+
+    m_lastStats = MctsStats();
+    m_lastStats.threads = m_threads;
+
+    if(m_nodes[0].state.load() != NODE_EXPANDED) {
+        return -1;
+    }
+
+    PerfSample perfBefore = PerfCounters::read();
+    std::vector<std::thread> helpers;
+    std::vector<uint64_t> playouts(m_threads, 0);
+    std::vector<int> depths(m_threads, 0);
+
+    for(int i = 1; i < m_threads; i++) {
+        helpers.emplace_back([&, i] {
+            TRACE_THREAD_NAME("mcts helper");
+            TRACE_SCOPE_ARG("mcts worker", "thread", i);
+            playouts[i] = this->worker(i, deadline, ctx, depths[i]);
+        });
+    }
+    playouts[0] = this->worker(0, deadline, ctx, depths[0]);
+
+    for(auto &helper : helpers) {
+        helper.join();
+    }
+    // The helpers have exited, so their counts are in this thread's.
+    PerfSample perf = PerfCounters::read().since(perfBefore);
+
+    // The most visited child is the most robust choice.
+    Node &root = m_nodes[0];
+    Node *children = &m_nodes[root.firstChild.load()];
+    Node *best = &children[0];
+    for(int i = 1; i < root.childCount; i++) {
+        if(children[i].visits.load() > best->visits.load()) {
+            best = &children[i];
+        }
+    }
+
+    for(int i = 0; i < m_threads; i++) {
+        m_lastStats.playouts += playouts[i];
+        m_lastStats.maxDepth = std::max(m_lastStats.maxDepth, depths[i]);
+    }
+    m_lastStats.treeNodes = std::min<uint64_t>(m_used.load(), m_capacity);
+    m_lastStats.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(SearchContext::now() - start).count();
+
+    int visits = best->visits.load();
+    m_lastStats.winRate = visits == 0 ? 0.5 : best->wins.load() / (2.0 * visits);
+
+    if(PerfCounters::isOpen()) {
+        Logger::logComment("Counters: " + perf.describe(m_lastStats.playouts, "playout"));
+    }
+
+    return best->move == MCTS_PASS ? -1 : best->move;
+}
+
+Move Mcts::selectMove(OthelloGameBoard &gameBoard, int playerColor) {
+    return this->selectMove(gameBoard, playerColor, (int64_t) (gameBoard.getCfg().getMoveTime() * 1000));
+}
+
+Move Mcts::selectMove(OthelloGameBoard &gameBoard, int playerColor, int64_t budgetMs) {
+    uint64_t player = gameBoard.getForColor(playerColor).getBits();
+    uint64_t opponent = gameBoard.getForColor(-playerColor).getBits();
+
+    m_lastSearch = SearchInfo();
+    if(OthelloGameBoard::generateMoveMask(player, opponent) == 0) {
+        return Move();
+    }
+
+    SearchContext ctx;
+    int pos = this->search(player, opponent, SearchContext::now() + std::chrono::milliseconds(budgetMs), ctx);
+
+    const MctsStats &stats = m_lastStats;
+    int score = (int) std::lround(stats.winRate * 100);
+
+    m_lastSearch.score = score;
+    m_lastSearch.depth = stats.maxDepth;
+    m_lastSearch.nodes = stats.playouts;
+    m_lastSearch.timeMs = stats.timeMs;
+
+    Logger::logComment("MCTS: " + std::to_string(stats.playouts) + " playouts (" +
+                       std::to_string((uint64_t) stats.getPlayoutsPerSecond()) + "/s) on " +
+                       std::to_string(stats.threads) + " threads, " + std::to_string(stats.treeNodes) +
+                       " tree nodes, depth " + std::to_string(stats.maxDepth) + ", win rate " +
+                       std::to_string(score) + "%");
+
+    if(pos < 0) {
+        return Move();
+    }
+    return Move(pos, score);
+}
@@ -0,0 +1,113 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_MCTS_H
+#define OTHELLOPROJECT_CPP_MCTS_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "SearchContext.h"
+#include "../OthelloGame/Move.h"
+#include "../OthelloGame/SearchInfo.h"
+
+class OthelloGameBoard;
+
+// Default arena size, in tree nodes (~48 bytes each).
+#define MCTS_DEFAULT_NODES (1 << 20)
+
+/**
+ * Statistics for the most recent Mcts::selectMove call.
+ */
+struct MctsStats {
+    uint64_t playouts = 0;
+    uint64_t treeNodes = 0;
+    uint64_t timeMs = 0;
+    int maxDepth = 0;
+    int threads = 0;
+    /**
+     * Expected result of the chosen move for the side to move, 0.0 (loss) to 1.0 (win).
+     */
+    double winRate = 0.0;
+
+    double getPlayoutsPerSecond() const;
+};
+
+/**
+ * Monte Carlo Tree Search engine.
+ *
+ * Uses UCT selection over a tree stored in a preallocated node arena, and light playouts
+ * (random moves, corners preferred, X-squares avoided) on raw bitboards through
+ * OthelloGameBoard::generateMoveMask and OthelloGameBoard::getFlips.
+ *
+ * Search is tree-parallel: every thread descends the shared tree, adding a virtual loss to the
+ * nodes on its path so that other threads spread out, and all visit / score updates are atomic.
+ * Nodes are expanded all children at once by whichever thread wins a CAS on the node state.
+ */
+class Mcts {
+public:
+    /**
+     * @param maxNodes Size of the node arena. Once it is full the tree stops growing,
+     * and playouts continue from the current leaves.
+     * @param threads Number of search threads, 0 for one per core.
+     */
+    explicit Mcts(size_t maxNodes = MCTS_DEFAULT_NODES, int threads = 0);
+    ~Mcts();
+
+    Mcts(const Mcts &) = delete;
+    Mcts &operator=(const Mcts &) = delete;
+
+    /**
+     * Selects a move for the given color within the move time of the board's Config.
+     * @return The most visited root move, or a pass if there are no legal moves.
+     */
+    Move selectMove(OthelloGameBoard &gameBoard, int playerColor);
+    /**
+     * Selects a move for the given color within budgetMs.
+     */
+    Move selectMove(OthelloGameBoard &gameBoard, int playerColor, int64_t budgetMs);
+    /**
+     * Searches until the deadline passes or ctx is stopped.
+     * @param player Bits of the side to move.
+     * @param opponent Bits of the other side.
+     * @return Board position of the most visited root move, or -1 for a pass.
+     */
+    int search(uint64_t player, uint64_t opponent, SearchContext::Clock::time_point deadline, SearchContext &ctx);
+
+    const MctsStats &getLastStats() const;
+    /**
+     * @return The last search summarized in the same form as the alpha-beta engine. The score is the
+     * win rate in percent, the depth is the deepest tree path and the node count is the number of playouts.
+     */
+    const SearchInfo &getLastSearchInfo() const;
+
+private:
+    struct Node;
+
+    std::unique_ptr<Node[]> m_nodes;
+    size_t m_capacity;
+    std::atomic<uint32_t> m_used;
+    int m_threads;
+
+    MctsStats m_lastStats;
+    SearchInfo m_lastSearch;
+
+    /**
+     * Claims count consecutive nodes from the arena.
+     * @return Index of the first node, or 0 if the arena is full (index 0 is always the root).
+     */
+    uint32_t allocate(int count);
+    void initNode(Node &node, uint64_t player, uint64_t opponent, int move);
+    /**
+     * Creates the children of node if this thread wins the race to do so.
+     */
+    void expand(Node &node);
+    /**
+     * Runs search iterations until the deadline or a stop, then returns the number of playouts.
+     */
+    uint64_t worker(int id, SearchContext::Clock::time_point deadline, SearchContext &ctx, int &maxDepth);
+};
+
+#endif //OTHELLOPROJECT_CPP_MCTS_H
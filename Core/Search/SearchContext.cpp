@@ -0,0 +1,159 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "SearchContext.h"
+
+SearchContext::SearchContext() : m_stop(false), m_timeUp(false), m_hasDeadline(false), m_nodes(0), m_nodeLimit(0),
+                                 m_stopCallback(nullptr), m_stopUser(nullptr), m_iterationCallback(nullptr),
+                                 m_iterationUser(nullptr), m_table(nullptr), m_solver(nullptr), m_recorder(nullptr),
+                                 m_start(now()), m_deadline(now()), m_seedLength(0), m_followPv(false) {
+    m_pvLength[0] = 0;
+}
+
+void SearchContext::reset() {
+    m_stop.store(false, std::memory_order_relaxed);
+    m_timeUp = false;
+    m_hasDeadline = false;
+    m_nodes = 0;
+    m_nodeLimit = 0;
+    m_stats = SearchStats();
+    m_start = now();
+    m_pvLength[0] = 0;
+    m_seedLength = 0;
+    m_followPv = false;
+    m_lines.clear();
+}
+
+void SearchContext::setDeadline(Clock::time_point deadline) {
+    m_deadline = deadline;
+    m_hasDeadline = true;
+    m_timeUp = now() >= deadline;
+}
+
+void SearchContext::clearDeadline() {
+    m_hasDeadline = false;
+    m_timeUp = false;
+}
+
+void SearchContext::setNodeLimit(uint64_t nodes) {
+    m_nodeLimit = nodes;
+}
+
+void SearchContext::setStopCallback(StopCallback callback, void *user) {
+    m_stopCallback = callback;
+    m_stopUser = user;
+}
+
+bool SearchContext::pollStopCallback() {
+    if(m_stopCallback != nullptr && m_stopCallback(m_stopUser)) {
+        this->stop();
+    }
+    return this->isStopped();
+}
+
+void SearchContext::setIterationCallback(IterationCallback callback, void *user) {
+    m_iterationCallback = callback;
+    m_iterationUser = user;
+}
+
+void SearchContext::reportIteration(const SearchInfo &info, const int *pv, int pvLength) {
+    if(m_iterationCallback != nullptr) {
+        m_iterationCallback(info, pv, pvLength, m_iterationUser);
+    }
+}
+
+void SearchContext::setTable(TranspositionTable *table) {
+    m_table = table;
+}
+
+void SearchContext::setSolver(DfpnSolver *solver) {
+    m_solver = solver;
+}
+
+void SearchContext::setRecorder(TreeRecorder *recorder) {
+    m_recorder = recorder;
+}
+
+void SearchContext::setParams(const SearchParams &params) {
+    m_params = params;
+}
+
+void SearchContext::stop() {
+    m_stop.store(true, std::memory_order_relaxed);
+}
+
+bool SearchContext::isStopped() const {
+    return m_stop.load(std::memory_order_relaxed);
+}
+
+uint64_t SearchContext::getNodes() const {
+    return m_nodes;
+}
+
+uint64_t SearchContext::getElapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now() - m_start).count();
+}
+
+bool SearchContext::checkTime() {
+    if(m_hasDeadline && now() >= m_deadline) {
+        m_timeUp = true;
+    }
+    if(m_nodeLimit != 0 && m_nodes >= m_nodeLimit) {
+        m_timeUp = true;
+    }
+    this->pollStopCallback();
+    return this->isAborted();
+}
+
+const int *SearchContext::getPv() const {
+    return m_pv[0];
+}
+
+int SearchContext::getPvLength() const {
+    return m_pvLength[0];
+}
+
+void SearchContext::clearLines() {
+    m_lines.clear();
+}
+
+void SearchContext::addLine(int move, int score, const int *pv, int pvLength) {
+    m_lines.push_back({ move, score, std::vector<int>(pv, pv + pvLength) });
+}
+
+const std::vector<SearchLine> &SearchContext::getLines() const {
+    return m_lines;
+}
+
+int SearchContext::copyRootLine(int move, int *line) const {
+    line[0] = move;
+    int length = std::max(1, m_pvLength[1]);
+    for(int i = 1; i < length; i++) {
+        line[i] = m_pv[1][i];
+    }
+    return length;
+}
+
+void SearchContext::seedPv() {
+    m_seedLength = m_pvLength[0];
+    for(int i = 0; i < m_seedLength; i++) {
+        m_seed[i] = m_pv[0][i];
+    }
+}
+
+int SearchContext::getSeedMove() const {
+    return m_seedLength > 0 ? m_seed[0] : -1;
+}
+
+const int *SearchContext::getSeedPv() const {
+    return m_seed;
+}
+
+int SearchContext::getSeedLength() const {
+    return m_seedLength;
+}
+
+void SearchContext::beginPvFollow() {
+    m_followPv = m_seedLength > 0;
+}
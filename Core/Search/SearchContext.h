@@ -0,0 +1,295 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_SEARCHCONTEXT_H
+#define OTHELLOPROJECT_CPP_SEARCHCONTEXT_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "SearchParams.h"
+#include "../OthelloGame/SearchInfo.h"
+
+class DfpnSolver;
+class TranspositionTable;
+class TreeRecorder;
+
+// The clock is only read once every (SEARCH_POLL_MASK + 1) nodes.
+#define SEARCH_POLL_MASK 1023
+// Deepest ply the principal variation is tracked to. A game has at most 60 moves.
+#define MAX_SEARCH_PLY 64
+
+/**
+ * Shared state for a single search: node counter, soft deadline, stop flag and principal variation.
+ *
+ * The search calls shouldStop() at every node. That is a counter increment and a relaxed
+ * atomic load; the steady clock is only polled every SEARCH_POLL_MASK + 1 nodes. The stop flag
+ * can be raised from any thread (watchdog, protocol "stop", API callers) and is sticky until
+ * the next reset(). A node limit and a stop callback are checked at the same points as the clock.
+ */
+class SearchContext {
+public:
+    typedef std::chrono::steady_clock Clock;
+    /**
+     * Asked periodically whether to stop the search. Must be cheap and thread-safe.
+     * @return True to stop.
+     */
+    typedef bool (*StopCallback)(void *user);
+    /**
+     * Receives a summary and the principal variation of every completed iteration.
+     */
+    typedef void (*IterationCallback)(const SearchInfo &info, const int *pv, int pvLength, void *user);
+
+    SearchContext();
+
+    /**
+     * Clears the stop flag, counters and deadline, and restarts the elapsed-time clock.
+     */
+    void reset();
+    /**
+     * Sets the soft deadline. Once it has passed, shouldStop() reports true until a new
+     * deadline is set. Does not touch the stop flag.
+     */
+    void setDeadline(Clock::time_point deadline);
+    /**
+     * Removes the soft deadline.
+     */
+    void clearDeadline();
+    /**
+     * Aborts the search once this many nodes have been searched. 0 for no limit. Cleared by reset().
+     */
+    void setNodeLimit(uint64_t nodes);
+    /**
+     * Installs a callback polled together with the clock. Survives reset(); pass nullptr to remove.
+     */
+    void setStopCallback(StopCallback callback, void *user);
+    /**
+     * Asks the stop callback, if any, and stops the search if it says so.
+     * @return isStopped()
+     */
+    bool pollStopCallback();
+    /**
+     * Installs a callback for completed iterations. Survives reset(); pass nullptr to remove.
+     */
+    void setIterationCallback(IterationCallback callback, void *user);
+    /**
+     * Passes a line of a completed iteration to the iteration callback. Called once per line
+     * (info.line) in multi-PV searches.
+     */
+    void reportIteration(const SearchInfo &info, const int *pv, int pvLength);
+    /**
+     * Aborts the search. Safe to call from any thread.
+     */
+    void stop();
+    /**
+     * Sets the transposition table the search uses, nullptr for none. Survives reset(); the
+     * table is not owned and must outlive the searches using it.
+     */
+    void setTable(TranspositionTable *table);
+
+    inline TranspositionTable *getTable() const {
+        return m_table;
+    }
+
+    /**
+     * Sets the proof-number solver tried on the root near the end of the game, nullptr for none (see
+     * SearchParams::dfpnEmpties). Survives reset(); not owned.
+     */
+    void setSolver(DfpnSolver *solver);
+
+    inline DfpnSolver *getSolver() const {
+        return m_solver;
+    }
+
+    /**
+     * Sets the recorder the top of the tree is written to, nullptr for none (see TreeRecorder).
+     * Survives reset(); not owned.
+     */
+    void setRecorder(TreeRecorder *recorder);
+
+    inline TreeRecorder *getRecorder() const {
+        return m_recorder;
+    }
+
+    /**
+     * Sets the pruning parameters. Survives reset().
+     */
+    void setParams(const SearchParams &params);
+
+    inline const SearchParams &getParams() const {
+        return m_params;
+    }
+
+    /**
+     * @return Counters of the current search, cleared by reset().
+     */
+    inline SearchStats &getStats() {
+        return m_stats;
+    }
+
+    /**
+     * Counts a node and checks whether the search must unwind.
+     */
+    inline bool shouldStop() {
+        if((++m_nodes & SEARCH_POLL_MASK) == 0) {
+            this->checkTime();
+        }
+        return m_timeUp || m_stop.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return True if the search was aborted, by stop(), the soft deadline or the node limit.
+     * Results computed after this became true are incomplete and must be discarded.
+     */
+    inline bool isAborted() const {
+        return m_timeUp || m_stop.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return True if stop() was called (as opposed to only the soft deadline passing).
+     */
+    bool isStopped() const;
+    /**
+     * Reads the clock right away instead of waiting for the next poll.
+     * @return isAborted()
+     */
+    bool checkTime();
+    uint64_t getNodes() const;
+    /**
+     * @return Milliseconds since the last reset().
+     */
+    uint64_t getElapsedMs() const;
+
+    static inline Clock::time_point now() {
+        return Clock::now();
+    }
+
+    // Principal variation. Rows of a triangular table, indexed by ply (the root is ply 0).
+
+    /**
+     * Marks the line at ply as empty. Called on entry to every node.
+     */
+    inline void clearPv(int ply) {
+        if(ply < MAX_SEARCH_PLY) {
+            m_pvLength[ply] = ply;
+        }
+    }
+
+    /**
+     * Records move as the best move at ply, followed by the line found below it.
+     */
+    inline void updatePv(int ply, int move) {
+        if(ply >= MAX_SEARCH_PLY) {
+            return;
+        }
+
+        m_pv[ply][ply] = move;
+        int length = ply + 1;
+        if(ply + 1 < MAX_SEARCH_PLY) {
+            for(int i = ply + 1; i < m_pvLength[ply + 1]; i++) {
+                m_pv[ply][i] = m_pv[ply + 1][i];
+            }
+            length = std::max(length, m_pvLength[ply + 1]);
+        }
+        m_pvLength[ply] = length;
+    }
+
+    /**
+     * @return The principal variation from the root, m_pvLength[0] moves long.
+     */
+    const int *getPv() const;
+    int getPvLength() const;
+    /**
+     * Copies the line of a root move that was just searched: move, then the line found below it.
+     * @param line At least MAX_SEARCH_PLY entries.
+     * @return The length of the line.
+     */
+    int copyRootLine(int move, int *line) const;
+    /**
+     * Forgets the lines of the previous iteration. Cleared by reset() as well.
+     */
+    void clearLines();
+    /**
+     * Adds a line of the last completed iteration, see getLines().
+     */
+    void addLine(int move, int score, const int *pv, int pvLength);
+    /**
+     * @return The best SearchLimits::multiPv lines of the last completed iteration, best first.
+     * Empty if no iteration completed.
+     */
+    const std::vector<SearchLine> &getLines() const;
+    /**
+     * Stores the current root principal variation so that the next iteration searches it first.
+     */
+    void seedPv();
+    /**
+     * @return The first move of the seeded principal variation, or -1.
+     */
+    int getSeedMove() const;
+    /**
+     * @return The seeded principal variation, i.e. the one from the last completed iteration.
+     */
+    const int *getSeedPv() const;
+    int getSeedLength() const;
+    /**
+     * Starts following the seeded line. Call right before searching the root move that starts it.
+     */
+    void beginPvFollow();
+    /**
+     * Stops following the seeded line. Called once the seeded move at some ply has been searched.
+     */
+    inline void leavePv() {
+        m_followPv = false;
+    }
+
+    /**
+     * @param ply The current ply.
+     * @param legalMoves Move mask at this node.
+     * @return The seeded move at this ply if the search is still on the seeded line and the move is legal,
+     * otherwise -1 (and the line is abandoned).
+     */
+    inline int getPvMove(int ply, uint64_t legalMoves) {
+        if(!m_followPv) {
+            return -1;
+        }
+
+        if(ply < m_seedLength && ((1ULL << m_seed[ply]) & legalMoves) != 0) {
+            return m_seed[ply];
+        }
+
+        m_followPv = false;
+        return -1;
+    }
+
+private:
+    std::atomic<bool> m_stop;
+    bool m_timeUp;
+    bool m_hasDeadline;
+    uint64_t m_nodes;
+    uint64_t m_nodeLimit;
+    StopCallback m_stopCallback;
+    void *m_stopUser;
+    IterationCallback m_iterationCallback;
+    void *m_iterationUser;
+    TranspositionTable *m_table;
+    DfpnSolver *m_solver;
+    TreeRecorder *m_recorder;
+    SearchParams m_params;
+    SearchStats m_stats;
+    Clock::time_point m_start;
+    Clock::time_point m_deadline;
+
+    int m_pv[MAX_SEARCH_PLY][MAX_SEARCH_PLY];
+    int m_pvLength[MAX_SEARCH_PLY];
+    int m_seed[MAX_SEARCH_PLY];
+    int m_seedLength;
+    bool m_followPv;
+    // Kept here rather than on the board, which the search copies at every node.
+    std::vector<SearchLine> m_lines;
+};
+
+#endif //OTHELLOPROJECT_CPP_SEARCHCONTEXT_H
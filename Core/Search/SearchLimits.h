@@ -0,0 +1,44 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_SEARCHLIMITS_H
+#define OTHELLOPROJECT_CPP_SEARCHLIMITS_H
+
+#include <cstdint>
+
+/**
+ * Limits for a single search. Zero means "not set". If no limit is set at all, the move time of
+ * the board's Config is used, as in a referee game.
+ */
+struct SearchLimits {
+    /**
+     * Time for this move, in milliseconds.
+     */
+    int64_t moveTimeMs = 0;
+    /**
+     * Deepest iteration to search. Alpha-beta only.
+     */
+    int depth = 0;
+    /**
+     * Node budget, checked every SEARCH_POLL_MASK + 1 nodes. Alpha-beta only.
+     */
+    uint64_t nodes = 0;
+    /**
+     * Search until stopped, or until the result is exact.
+     */
+    bool infinite = false;
+    /**
+     * Number of best moves to search with exact scores and report (multi-PV). Alpha-beta only.
+     */
+    int multiPv = 1;
+
+    /**
+     * @return True if none of the limits is set and the Config move time applies.
+     */
+    bool useConfigTime() const {
+        return moveTimeMs <= 0 && depth <= 0 && nodes == 0 && !infinite;
+    }
+};
+
+#endif //OTHELLOPROJECT_CPP_SEARCHLIMITS_H
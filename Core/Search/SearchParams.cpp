@@ -0,0 +1,120 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "SearchParams.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+const std::vector<ParamSpec> &SearchParams::getSpecs() {
+    static const std::vector<ParamSpec> specs = {
+            { "etc_min_draft", &SearchParams::etcMinDraft, 1, 20, 1 },
+            { "lmr_min_draft", &SearchParams::lmrMinDraft, 2, 20, 1 },
+            { "lmr_min_moves", &SearchParams::lmrMinMoves, 1, 20, 1 },
+            { "lmr_reduction", &SearchParams::lmrReduction, 0, 4, 1 },
+            { "depth_start", &SearchParams::depthStart, 1, 10, 1 },
+            { "depth_step", &SearchParams::depthStep, 1, 4, 1 },
+            { "move_time_divisor", &SearchParams::moveTimeDivisor, 5, 120, 3 },
+            { "dfpn_empties", &SearchParams::dfpnEmpties, 0, 40, 1 },
+            { "dfpn_time_share", &SearchParams::dfpnTimeShare, 5, 90, 5 },
+            { "corner_weight", &SearchParams::cornerWeight, 0, 1000, 10 },
+            { "adjacent_weight", &SearchParams::adjacentWeight, 0, 1000, 8 },
+            { "mobility_weight", &SearchParams::mobilityWeight, 0, 1000, 5 },
+            { "parity_weight", &SearchParams::parityWeight, 0, 1000, 4 },
+            { "stability_weight", &SearchParams::stabilityWeight, 0, 1000, 2 },
+            { "parity_endgame_discs", &SearchParams::parityEndgameDiscs, 40, 64, 1 },
+            { "parity_endgame_weight", &SearchParams::parityEndgameWeight, 0, 1000, 8 }
+    };
+    return specs;
+}
+
+uint64_t SearchParams::getEvalSignature() const {
+    const int weights[] = { this->cornerWeight, this->adjacentWeight, this->mobilityWeight, this->parityWeight,
+                            this->stabilityWeight, this->parityEndgameDiscs, this->parityEndgameWeight };
+
+    // FNV-1a over the weights' bytes, low byte first.
+    uint64_t signature = 0xCBF29CE484222325ULL;
+    for(int weight : weights) {
+        for(int shift = 0; shift < 32; shift += 8) {
+            signature = (signature ^ (((uint32_t) weight >> shift) & 0xFF)) * 0x100000001B3ULL;
+        }
+    }
+    return signature;
+}
+
+void SearchParams::clamp() {
+    for(const ParamSpec &spec : getSpecs()) {
+        this->*spec.field = std::max(spec.min, std::min(spec.max, this->*spec.field));
+    }
+}
+
+bool SearchParams::load(const std::string &path, std::string &error) {
+    std::ifstream in(path);
+    if(!in) {
+        error = "cannot read " + path;
+        return false;
+    }
+
+    int lineNumber = 0;
+    for(std::string line; std::getline(in, line);) {
+        lineNumber++;
+        std::istringstream words(line);
+        std::string name;
+        if(!(words >> name) || name[0] == '#') {
+            continue;
+        }
+
+        int value;
+        if(!(words >> value)) {
+            error = path + ":" + std::to_string(lineNumber) + ": missing or malformed value for " + name;
+            return false;
+        }
+
+        if(name == "etc" || name == "lmr" || name == "lazy_eval") {
+            (name == "etc" ? this->etc : name == "lmr" ? this->lmr : this->lazyEval) = value != 0;
+            continue;
+        }
+
+        const std::vector<ParamSpec> &specs = getSpecs();
+        auto spec = std::find_if(specs.begin(), specs.end(), [&](const ParamSpec &s) { return name == s.name; });
+        if(spec == specs.end()) {
+            error = path + ":" + std::to_string(lineNumber) + ": unknown parameter " + name;
+            return false;
+        }
+        this->*spec->field = value;
+    }
+
+    this->clamp();
+    return true;
+}
+
+bool SearchParams::save(const std::string &path, const std::string &comment) const {
+    // Written next to the target and renamed over it, so a reader never sees a partial file.
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp);
+        if(!comment.empty()) {
+            out << "# " << comment << "\n";
+        }
+        out << "etc " << (this->etc ? 1 : 0) << "\n";
+        out << "lmr " << (this->lmr ? 1 : 0) << "\n";
+        out << "lazy_eval " << (this->lazyEval ? 1 : 0) << "\n";
+        for(const ParamSpec &spec : getSpecs()) {
+            out << spec.name << " " << this->*spec.field << "\n";
+        }
+
+        if(!out.flush()) {
+            std::remove(temp.c_str());
+            return false;
+        }
+    }
+
+    if(std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::remove(temp.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,146 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_SEARCHPARAMS_H
+#define OTHELLOPROJECT_CPP_SEARCHPARAMS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct SearchParams;
+
+/**
+ * An integer member of SearchParams that can be set by name and tuned (see Tuner).
+ */
+struct ParamSpec {
+    const char *name;
+    int SearchParams::*field;
+    int min;
+    int max;
+    /**
+     * Smallest change worth testing. The tuner perturbs in multiples of it.
+     */
+    int step;
+};
+
+/**
+ * Runtime parameters of the alpha-beta engine: pruning, iterative deepening, time management and
+ * the evaluation weights. Drafts are remaining depths in plies.
+ *
+ * Parameter files hold one "name value" pair per line, names as in getSpecs() plus "etc", "lmr"
+ * and "lazy_eval" (0 or 1). Lines starting with '#' are comments; parameters that are not mentioned keep their value.
+ */
+struct SearchParams {
+    /**
+     * Enhanced transposition cutoffs: before searching any move, look up every child in the
+     * transposition table and cut off if one of them already refutes the window.
+     */
+    bool etc = true;
+    /**
+     * Minimum draft for ETC. The extra move generation and probes only pay off near the root.
+     */
+    int etcMinDraft = 4;
+
+    /**
+     * Late-move reductions: moves late in the ordering are searched lmrReduction plies shallower,
+     * and searched again at full depth if they turn out better than the best move so far.
+     * Never applied where the search reaches the end of the game, so that endgame solves stay exact.
+     */
+    bool lmr = true;
+    int lmrMinDraft = 3;
+    /**
+     * Number of moves searched at full depth before reductions start.
+     */
+    int lmrMinMoves = 3;
+    int lmrReduction = 1;
+
+    /**
+     * Lazy evaluation: leaves whose score cannot reach the window even with the best and worst
+     * mobility are cut before the move generation mobility needs.
+     */
+    bool lazyEval = true;
+
+    /**
+     * Iterative deepening: the first iteration's depth, and how much deeper each next one goes.
+     */
+    int depthStart = 2;
+    int depthStep = 2;
+    /**
+     * Each move without other limits gets the game time divided by this.
+     */
+    int moveTimeDivisor = 30;
+    /**
+     * With a DfpnSolver in the SearchContext and at most this many empty squares, the root is first
+     * given to the proof-number solver for dfpnTimeShare percent of the move time. 0 to never use it.
+     */
+    int dfpnEmpties = 20;
+    int dfpnTimeShare = 25;
+
+    // Weights of the heuristic evaluation terms. Not used by the neural evaluator.
+    int cornerWeight = 100;
+    int adjacentWeight = 60;
+    int mobilityWeight = 40;
+    int parityWeight = 20;
+    int stabilityWeight = 5;
+    /**
+     * Once this many discs are on the board, parity weighs parityEndgameWeight instead.
+     */
+    int parityEndgameDiscs = 58;
+    int parityEndgameWeight = 75;
+
+    /**
+     * @return Hash of the heuristic evaluation weights. Scores of searches with different weights
+     * cannot be mixed.
+     */
+    uint64_t getEvalSignature() const;
+    /**
+     * @return Every integer parameter with its legal range.
+     */
+    static const std::vector<ParamSpec> &getSpecs();
+    /**
+     * Clamps every parameter into its range.
+     */
+    void clamp();
+    /**
+     * Reads a parameter file over the current values.
+     * @param error Set to a description of the first problem when false is returned.
+     * @return False if the file cannot be read or holds an unknown name or a malformed value.
+     */
+    bool load(const std::string &path, std::string &error);
+    /**
+     * Writes every parameter, replacing the file atomically.
+     * @param comment Written as a comment line at the top, if not empty.
+     */
+    bool save(const std::string &path, const std::string &comment = "") const;
+};
+
+/**
+ * How often each technique fired during one search.
+ */
+struct SearchStats {
+    /**
+     * Nodes cut off by their own transposition table entry.
+     */
+    uint64_t ttCutoffs = 0;
+    /**
+     * Nodes whose children were probed for ETC, and how many of them were cut off by a child.
+     */
+    uint64_t etcProbes = 0;
+    uint64_t etcCutoffs = 0;
+    /**
+     * Moves searched at reduced depth, and how many of them had to be searched again.
+     */
+    uint64_t lmrReductions = 0;
+    uint64_t lmrResearches = 0;
+    /**
+     * Leaves scored by the lazy evaluator, and how many of them were cut before any move generation
+     * and after one side's only.
+     */
+    uint64_t lazyEvals = 0;
+    uint64_t lazyCheapExits = 0;
+    uint64_t lazyMobilityExits = 0;
+};
+
+#endif //OTHELLOPROJECT_CPP_SEARCHPARAMS_H
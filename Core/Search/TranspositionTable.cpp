@@ -0,0 +1,249 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "TranspositionTable.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Zobrist.h"
+#include "../Eval/Nnue.h"
+#include "../Records/ByteIO.h"
+#include "../Trace.h"
+
+namespace {
+
+// Written in host order: a file from a machine with the other byte order reads back reversed.
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+// Header field offsets.
+const size_t H_MAGIC = 0;
+const size_t H_VERSION = 4;
+const size_t H_ENTRY_SIZE = 8;
+const size_t H_BYTE_ORDER = 12;
+const size_t H_ENTRY_COUNT = 16;
+const size_t H_ZOBRIST = 24;
+const size_t H_EVALUATOR = 32;
+const size_t H_GENERATION = 40;
+const size_t H_CHECKSUM = 56;
+
+// Entries of this many buckets are sampled by getUsage().
+const size_t USAGE_SAMPLE_BUCKETS = 250;
+
+uint8_t *mapAnonymous(size_t size) {
+    void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return mapped == MAP_FAILED ? nullptr : (uint8_t *) mapped;
+}
+
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes) : m_base(nullptr), m_mapSize(0), m_entries(nullptr),
+                                                           m_bucketMask(0), m_generation(0), m_readOnly(false) {
+    size_t buckets = 1;
+    while(buckets * 2 * TT_BUCKET_SIZE * sizeof(TTEntry) <= megabytes * 1024 * 1024) {
+        buckets *= 2;
+    }
+
+    // Anonymous mappings are zeroed, i.e. every entry is empty (TTBound::None).
+    m_mapSize = HEADER_SIZE + buckets * TT_BUCKET_SIZE * sizeof(TTEntry);
+    m_base = mapAnonymous(m_mapSize);
+    if(m_base == nullptr) {
+        // Fall back to a single bucket rather than failing the whole engine.
+        m_mapSize = HEADER_SIZE + TT_BUCKET_SIZE * sizeof(TTEntry);
+        m_base = mapAnonymous(m_mapSize);
+        buckets = 1;
+    }
+
+    m_entries = (TTEntry *) (m_base + HEADER_SIZE);
+    m_bucketMask = buckets - 1;
+}
+
+TranspositionTable::~TranspositionTable() {
+    this->release();
+}
+
+void TranspositionTable::release() {
+    if(m_base != nullptr) {
+        munmap(m_base, m_mapSize);
+        m_base = nullptr;
+    }
+}
+
+void TranspositionTable::store(uint64_t key, int score, int move, int draft, TTBound bound) {
+    if(m_readOnly) {
+        return;
+    }
+
+    TTEntry *bucket = m_entries + (key & m_bucketMask) * TT_BUCKET_SIZE;
+
+    // Same position or an empty slot first (slots fill in order), otherwise the shallowest and oldest entry.
+    TTEntry *victim = bucket;
+    int victimValue = INT32_MAX;
+    for(int i = 0; i < TT_BUCKET_SIZE; i++) {
+        TTEntry &entry = bucket[i];
+        if(entry.key == key || entry.bound == TTBound::None) {
+            victim = &entry;
+            break;
+        }
+
+        int value = entry.draft - 8 * (uint8_t) (m_generation - entry.generation);
+        if(value < victimValue) {
+            victim = &entry;
+            victimValue = value;
+        }
+    }
+
+    if(victim->key == key && victim->bound != TTBound::None) {
+        // A deeper result from this search is worth more than a shallow bound.
+        if(victim->generation == m_generation && victim->draft > draft && bound != TTBound::Exact) {
+            return;
+        }
+        if(move < 0) {
+            move = victim->move == TT_NO_MOVE ? -1 : victim->move;
+        }
+    }
+
+    victim->key = key;
+    victim->score = score;
+    victim->move = move < 0 ? TT_NO_MOVE : (uint8_t) move;
+    victim->draft = (uint8_t) std::min(draft, 255);
+    victim->bound = bound;
+    victim->generation = m_generation;
+}
+
+void TranspositionTable::newSearch() {
+    m_generation++;
+}
+
+void TranspositionTable::clear() {
+    if(!m_readOnly) {
+        memset(m_entries, 0, this->getCapacity() * sizeof(TTEntry));
+    }
+}
+
+size_t TranspositionTable::getCapacity() const {
+    return (m_bucketMask + 1) * TT_BUCKET_SIZE;
+}
+
+int TranspositionTable::getUsage() const {
+    size_t buckets = std::min<size_t>(USAGE_SAMPLE_BUCKETS, m_bucketMask + 1);
+    size_t used = 0;
+    for(size_t i = 0; i < buckets * TT_BUCKET_SIZE; i++) {
+        used += m_entries[i].bound != TTBound::None;
+    }
+    return (int) (used * 1000 / (buckets * TT_BUCKET_SIZE));
+}
+
+bool TranspositionTable::isReadOnly() const {
+    return m_readOnly;
+}
+
+void TranspositionTable::writeHeader(uint8_t *header, const SearchParams &params) const {
+    memset(header, 0, HEADER_SIZE);
+    ByteIO::putU32(header + H_MAGIC, MAGIC);
+    ByteIO::putU32(header + H_VERSION, VERSION);
+    ByteIO::putU32(header + H_ENTRY_SIZE, sizeof(TTEntry));
+    memcpy(header + H_BYTE_ORDER, &BYTE_ORDER_MARK, sizeof(BYTE_ORDER_MARK));
+    ByteIO::putU64(header + H_ENTRY_COUNT, this->getCapacity());
+    ByteIO::putU64(header + H_ZOBRIST, Zobrist::getSignature());
+    ByteIO::putU64(header + H_EVALUATOR, getEvaluatorSignature(params));
+    ByteIO::putU32(header + H_GENERATION, m_generation);
+    ByteIO::putU64(header + H_CHECKSUM, headerChecksum(header));
+}
+
+bool TranspositionTable::save(const std::string &path, const SearchParams &params) const {
+    TRACE_SCOPE("hash save");
+    uint8_t header[HEADER_SIZE];
+    this->writeHeader(header, params);
+
+    // Written next to the target and renamed over it, so readers never see a partial file.
+    std::string temp = path + ".tmp";
+    std::FILE *file = std::fopen(temp.c_str(), "wb");
+    if(file == nullptr) {
+        return false;
+    }
+
+    size_t entryBytes = this->getCapacity() * sizeof(TTEntry);
+    bool ok = std::fwrite(header, 1, HEADER_SIZE, file) == HEADER_SIZE &&
+              std::fwrite(m_entries, 1, entryBytes, file) == entryBytes;
+    ok = std::fclose(file) == 0 && ok;
+
+    if(!ok || std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::remove(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool TranspositionTable::load(const std::string &path, const SearchParams &params, bool readOnly) {
+    TRACE_SCOPE("hash load");
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+
+    struct stat st{};
+    if(fstat(fd, &st) != 0 || (size_t) st.st_size < HEADER_SIZE + TT_BUCKET_SIZE * sizeof(TTEntry)) {
+        close(fd);
+        return false;
+    }
+
+    // Private mappings are copy-on-write: untouched pages stay shared with the page cache.
+    size_t size = (size_t) st.st_size;
+    void *mapped = readOnly ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)
+                            : mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mapped == MAP_FAILED) {
+        return false;
+    }
+
+    const uint8_t *header = (const uint8_t *) mapped;
+    uint64_t count = ByteIO::getU64(header + H_ENTRY_COUNT);
+    uint32_t byteOrder;
+    memcpy(&byteOrder, header + H_BYTE_ORDER, sizeof(byteOrder));
+
+    bool valid = ByteIO::getU32(header + H_MAGIC) == MAGIC &&
+                 ByteIO::getU32(header + H_VERSION) == VERSION &&
+                 ByteIO::getU32(header + H_ENTRY_SIZE) == sizeof(TTEntry) &&
+                 byteOrder == BYTE_ORDER_MARK &&
+                 ByteIO::getU64(header + H_CHECKSUM) == headerChecksum(header) &&
+                 ByteIO::getU64(header + H_ZOBRIST) == Zobrist::getSignature() &&
+                 ByteIO::getU64(header + H_EVALUATOR) == getEvaluatorSignature(params) &&
+                 count >= TT_BUCKET_SIZE && count % TT_BUCKET_SIZE == 0 &&
+                 ((count / TT_BUCKET_SIZE) & (count / TT_BUCKET_SIZE - 1)) == 0 &&
+                 size == HEADER_SIZE + count * sizeof(TTEntry);
+    if(!valid) {
+        munmap(mapped, size);
+        return false;
+    }
+
+    // Probes land anywhere in the table; readahead would only pull in pages that are never used.
+    madvise(mapped, size, MADV_RANDOM);
+
+    this->release();
+    m_base = (uint8_t *) mapped;
+    m_mapSize = size;
+    m_entries = (TTEntry *) (m_base + HEADER_SIZE);
+    m_bucketMask = count / TT_BUCKET_SIZE - 1;
+    m_generation = (uint8_t) ByteIO::getU32(header + H_GENERATION);
+    m_readOnly = readOnly;
+    return true;
+}
+
+uint64_t TranspositionTable::getEvaluatorSignature(const SearchParams &params) {
+    return Nnue::isLoaded() ? Nnue::getSignature() : params.getEvalSignature();
+}
+
+uint64_t TranspositionTable::headerChecksum(const uint8_t *header) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for(size_t i = 0; i < H_CHECKSUM; i++) {
+        hash = (hash ^ header[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
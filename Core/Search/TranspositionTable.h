@@ -0,0 +1,166 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_TRANSPOSITIONTABLE_H
+#define OTHELLOPROJECT_CPP_TRANSPOSITIONTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "SearchParams.h"
+
+// Table size used when none is configured.
+#define TT_DEFAULT_MB 64
+// Entries per bucket. A bucket is one 64 byte cache line.
+#define TT_BUCKET_SIZE 4
+// TTEntry::move value for entries without a best move.
+#define TT_NO_MOVE 255
+
+/**
+ * How a stored score relates to the true score of the position.
+ */
+enum class TTBound : uint8_t {
+    None = 0,
+    /**
+     * The true score is at most the stored score (no move raised alpha).
+     */
+    Upper,
+    /**
+     * The true score is at least the stored score (a move reached beta).
+     */
+    Lower,
+    Exact
+};
+
+/**
+ * One stored search result. Scores are from the point of view of the side to move, so that searches
+ * for either player share entries.
+ */
+struct TTEntry {
+    uint64_t key;
+    int32_t score;
+    uint8_t move;
+    /**
+     * Remaining depth the score was searched to.
+     */
+    uint8_t draft;
+    TTBound bound;
+    uint8_t generation;
+};
+
+static_assert(sizeof(TTEntry) == 16, "TTEntry is written to snapshots as is");
+
+/**
+ * Transposition table for the alpha-beta search, keyed by Zobrist keys.
+ *
+ * The table lives in one mapping: a snapshot header followed by the buckets. It can be saved to a
+ * snapshot file and mapped back in later, so that a new game starts with the results of earlier
+ * ones. Loading is a single mmap with header validation, whatever the table size; pages are only
+ * read in as the search touches them.
+ *
+ * Snapshot layout:
+ *   [header : 64 bytes, little-endian]  magic "OTT1", version, entry size, byte order mark,
+ *                                       entry count, Zobrist signature, evaluator signature,
+ *                                       generation, header checksum (FNV-1a of the bytes before it)
+ *   [entries : 16 bytes each]           TTEntry in host byte order, TT_BUCKET_SIZE per bucket
+ *
+ * A snapshot is rejected if any header field does not match this build, the evaluator (the loaded
+ * network or the heuristic weights) or the file size. A loaded table is copy-on-write: pages are
+ * shared with every other process that mapped the same file until they are written. A read-only
+ * load maps the file shared and ignores stores, so that any number of engine processes can probe
+ * one copy in the page cache.
+ *
+ * Not thread-safe: a table is used by one search at a time.
+ */
+class TranspositionTable {
+public:
+    /**
+     * Allocates an empty table of at most megabytes (rounded down to a power of two buckets).
+     */
+    explicit TranspositionTable(size_t megabytes = TT_DEFAULT_MB);
+    ~TranspositionTable();
+
+    TranspositionTable(const TranspositionTable &) = delete;
+    TranspositionTable &operator=(const TranspositionTable &) = delete;
+
+    /**
+     * Looks up a position.
+     * @param entry Set to the stored entry on a hit.
+     * @return True if the position is stored.
+     */
+    inline bool probe(uint64_t key, TTEntry &entry) const {
+        const TTEntry *bucket = m_entries + (key & m_bucketMask) * TT_BUCKET_SIZE;
+        for(int i = 0; i < TT_BUCKET_SIZE; i++) {
+            if(bucket[i].key == key && bucket[i].bound != TTBound::None) {
+                entry = bucket[i];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Stores a search result, replacing the same position or the least valuable entry of its bucket.
+     * @param move Best move, or -1.
+     */
+    void store(uint64_t key, int score, int move, int draft, TTBound bound);
+    /**
+     * Starts a new search. Entries from older searches are replaced first.
+     */
+    void newSearch();
+    void clear();
+
+    /**
+     * @return Number of entries the table can hold.
+     */
+    size_t getCapacity() const;
+    /**
+     * @return Per mille of a sample of entries that are in use.
+     */
+    int getUsage() const;
+    bool isReadOnly() const;
+
+    /**
+     * Writes the table to a snapshot file, replacing it atomically.
+     * @param params Parameters the table's scores were searched with.
+     * @return False on I/O failure.
+     */
+    bool save(const std::string &path, const SearchParams &params) const;
+    /**
+     * Replaces the table with a snapshot file. The table takes the snapshot's size.
+     * @param params Parameters the table will be searched with. Snapshots of another evaluator,
+     * or of the heuristic with other weights, do not validate.
+     * @param readOnly Map the file shared and read-only; stores are ignored afterwards.
+     * @return False, leaving the table unchanged, if the file is missing or does not validate.
+     */
+    bool load(const std::string &path, const SearchParams &params, bool readOnly = false);
+
+    static const uint32_t MAGIC = 0x3154544F; // "OTT1"
+    static const uint32_t VERSION = 2;
+    static const size_t HEADER_SIZE = 64;
+
+private:
+    // Start of the mapping, i.e. the header.
+    uint8_t *m_base;
+    size_t m_mapSize;
+    TTEntry *m_entries;
+    uint64_t m_bucketMask;
+    uint8_t m_generation;
+    bool m_readOnly;
+
+    void release();
+    /**
+     * Fills a header describing this table.
+     */
+    void writeHeader(uint8_t *header, const SearchParams &params) const;
+
+    /**
+     * @return The signature of the loaded network, or of the heuristic weights in params.
+     */
+    static uint64_t getEvaluatorSignature(const SearchParams &params);
+    static uint64_t headerChecksum(const uint8_t *header);
+};
+
+#endif //OTHELLOPROJECT_CPP_TRANSPOSITIONTABLE_H
@@ -0,0 +1,118 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "TreeRecorder.h"
+
+#include "../Records/ByteIO.h"
+
+// Amount of encoded records held in memory before they are written out mid-search.
+#define TREE_BUFFER_BYTES (4 * 1024 * 1024)
+
+TreeRecorder::TreeRecorder(const std::string &path, int maxPly, int sampleEvery) :
+        m_file(std::fopen(path.c_str(), "wb")), m_maxPly(maxPly), m_sampleEvery(sampleEvery < 1 ? 1 : sampleEvery),
+        m_recording(false), m_nextFlags(0), m_searches(0), m_recorded(0), m_records(0) {
+    m_buffer.reserve(TREE_BUFFER_BYTES + RECORD_SIZE);
+    if(m_file == nullptr) {
+        return;
+    }
+
+    uint8_t header[HEADER_SIZE] = {};
+    ByteIO::putU32(header, MAGIC);
+    ByteIO::putU32(header + 4, VERSION);
+    ByteIO::putU32(header + 8, RECORD_SIZE);
+    std::fwrite(header, 1, HEADER_SIZE, m_file);
+}
+
+TreeRecorder::~TreeRecorder() {
+    this->flush();
+    if(m_file != nullptr) {
+        std::fclose(m_file);
+    }
+}
+
+bool TreeRecorder::isOpen() const {
+    return m_file != nullptr;
+}
+
+void TreeRecorder::beginSearch() {
+    m_recording = m_file != nullptr && m_searches++ % m_sampleEvery == 0;
+    m_nextFlags = 0;
+}
+
+void TreeRecorder::endSearch() {
+    if(m_recording) {
+        m_recorded++;
+    }
+    m_recording = false;
+    this->flush();
+}
+
+void TreeRecorder::add(TreeRecord record) {
+    record.search = m_recorded;
+    size_t offset = m_buffer.size();
+    m_buffer.resize(offset + RECORD_SIZE);
+    encode(record, m_buffer.data() + offset);
+    m_records++;
+
+    if(m_buffer.size() >= TREE_BUFFER_BYTES) {
+        this->flush();
+    }
+}
+
+uint64_t TreeRecorder::getRecordCount() const {
+    return m_records;
+}
+
+uint32_t TreeRecorder::getSearchCount() const {
+    return m_recorded;
+}
+
+void TreeRecorder::encode(const TreeRecord &record, uint8_t *out) {
+    ByteIO::putU64(out, record.key);
+    ByteIO::putU32(out + 8, (uint32_t) record.alpha);
+    ByteIO::putU32(out + 12, (uint32_t) record.beta);
+    ByteIO::putU32(out + 16, (uint32_t) record.score);
+    ByteIO::putU32(out + 20, record.nodes);
+    ByteIO::putU32(out + 24, record.search);
+    out[28] = record.ply;
+    out[29] = record.draft;
+    out[30] = record.empties;
+    out[31] = record.moveCount;
+    out[32] = record.bestIndex;
+    out[33] = record.bestMove;
+    out[34] = record.flags;
+    out[35] = record.iteration;
+}
+
+TreeRecord TreeRecorder::decode(const uint8_t *data) {
+    TreeRecord record;
+    record.key = ByteIO::getU64(data);
+    record.alpha = (int32_t) ByteIO::getU32(data + 8);
+    record.beta = (int32_t) ByteIO::getU32(data + 12);
+    record.score = (int32_t) ByteIO::getU32(data + 16);
+    record.nodes = ByteIO::getU32(data + 20);
+    record.search = ByteIO::getU32(data + 24);
+    record.ply = data[28];
+    record.draft = data[29];
+    record.empties = data[30];
+    record.moveCount = data[31];
+    record.bestIndex = data[32];
+    record.bestMove = data[33];
+    record.flags = data[34];
+    record.iteration = data[35];
+    return record;
+}
+
+bool TreeRecorder::flush() {
+    if(m_buffer.empty() || m_file == nullptr) {
+        m_buffer.clear();
+        return m_file != nullptr;
+    }
+
+    size_t written = std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+    std::fflush(m_file);
+    bool ok = written == m_buffer.size();
+    m_buffer.clear();
+    return ok;
+}
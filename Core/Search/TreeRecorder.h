@@ -0,0 +1,160 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_TREERECORDER_H
+#define OTHELLOPROJECT_CPP_TREERECORDER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Record flags: how a node ended...
+#define TREE_FLAG_LEAF 0x01
+#define TREE_FLAG_PASS 0x02
+#define TREE_FLAG_TT_CUTOFF 0x04
+#define TREE_FLAG_ETC_CUTOFF 0x08
+// ...how its parent searched it...
+#define TREE_FLAG_REDUCED 0x10
+#define TREE_FLAG_RESEARCH 0x20
+// ...and where its first move came from.
+#define TREE_FLAG_TT_MOVE 0x40
+#define TREE_FLAG_PV_MOVE 0x80
+
+// bestIndex of a node that searched no move.
+#define TREE_NO_INDEX 0xFF
+// bestMove of a node without one.
+#define TREE_NO_MOVE 0xFF
+
+/**
+ * One searched node. Window and score are from the side to move's point of view, so a node failed
+ * high (cut off) if score >= beta and low if score <= alpha, whichever side was to move.
+ *
+ * On-disk layout (little-endian, no padding, TreeRecorder::RECORD_SIZE bytes):
+ *   uint64 key, int32 alpha, int32 beta, int32 score, uint32 nodes, uint32 search,
+ *   uint8 ply, draft, empties, moveCount, bestIndex, bestMove, flags, iteration
+ */
+struct TreeRecord {
+    /**
+     * Zobrist key for the side to move (see Zobrist).
+     */
+    uint64_t key = 0;
+    int32_t alpha = 0;
+    int32_t beta = 0;
+    int32_t score = 0;
+    /**
+     * Nodes in the subtree, this one included, recorded or not. Saturates at UINT32_MAX.
+     */
+    uint32_t nodes = 0;
+    /**
+     * Index of the recorded selectMove call the node belongs to.
+     */
+    uint32_t search = 0;
+    /**
+     * Distance from the root, which is ply 0.
+     */
+    uint8_t ply = 0;
+    /**
+     * Remaining depth when the node was searched.
+     */
+    uint8_t draft = 0;
+    uint8_t empties = 0;
+    uint8_t moveCount = 0;
+    /**
+     * Position in search order of the move that produced the score, TREE_NO_INDEX if none was
+     * searched. For a node that failed high, the move that caused the cutoff.
+     */
+    uint8_t bestIndex = TREE_NO_INDEX;
+    uint8_t bestMove = TREE_NO_MOVE;
+    uint8_t flags = 0;
+    /**
+     * Depth of the iterative deepening iteration.
+     */
+    uint8_t iteration = 0;
+};
+
+/**
+ * Records the top of the alpha-beta tree into a binary file for offline analysis of move ordering
+ * (see TreeAnalyzer). Opt in by setting it on a SearchContext.
+ *
+ * Only nodes up to maxPly from the root are recorded, and only in one of every sampleEvery searches.
+ * Records are written when a node is finished, so every subtree comes before its root. The file
+ * starts with a HEADER_SIZE header: magic, version and record size as uint32 each, then 4 bytes
+ * reserved.
+ *
+ * Records are buffered and written out between searches, or during one once the buffer is full.
+ * Not thread-safe: a recorder is used by one search at a time.
+ */
+class TreeRecorder {
+public:
+    static const uint32_t MAGIC = 0x3152544F; // "OTR1"
+    static const uint32_t VERSION = 1;
+    static const size_t HEADER_SIZE = 16;
+    static const size_t RECORD_SIZE = 36;
+
+    /**
+     * @param path File to write, replaced if it exists.
+     * @param maxPly Deepest ply recorded.
+     * @param sampleEvery Record one search in this many.
+     */
+    TreeRecorder(const std::string &path, int maxPly = 6, int sampleEvery = 1);
+    ~TreeRecorder();
+
+    TreeRecorder(const TreeRecorder &) = delete;
+    TreeRecorder &operator=(const TreeRecorder &) = delete;
+
+    /**
+     * @return False if the file could not be created.
+     */
+    bool isOpen() const;
+    /**
+     * Starts the next search, which is recorded if it is one of the sampled ones.
+     */
+    void beginSearch();
+    /**
+     * Writes the search's records out.
+     */
+    void endSearch();
+    /**
+     * @return True if a node at ply is to be recorded.
+     */
+    inline bool shouldRecord(int ply) const {
+        return m_recording && ply <= m_maxPly;
+    }
+    /**
+     * Flags for the next node that is recorded, set by its parent just before searching it.
+     */
+    inline void setNextFlags(uint8_t flags) {
+        m_nextFlags = flags;
+    }
+    inline uint8_t takeNextFlags() {
+        uint8_t flags = m_nextFlags;
+        m_nextFlags = 0;
+        return flags;
+    }
+    /**
+     * Adds a finished node. The search index is filled in.
+     */
+    void add(TreeRecord record);
+    uint64_t getRecordCount() const;
+    uint32_t getSearchCount() const;
+
+    static void encode(const TreeRecord &record, uint8_t *out);
+    static TreeRecord decode(const uint8_t *data);
+
+private:
+    std::FILE *m_file;
+    int m_maxPly;
+    int m_sampleEvery;
+    bool m_recording;
+    uint8_t m_nextFlags;
+    uint32_t m_searches;
+    uint32_t m_recorded;
+    uint64_t m_records;
+    std::vector<uint8_t> m_buffer;
+
+    bool flush();
+};
+
+#endif //OTHELLOPROJECT_CPP_TREERECORDER_H
@@ -0,0 +1,31 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "Watchdog.h"
+
+Watchdog::Watchdog(SearchContext &ctx, SearchContext::Clock::time_point hardDeadline) :
+        m_ctx(ctx), m_deadline(hardDeadline), m_cancelled(false), m_fired(false) {
+    m_thread = std::thread(&Watchdog::run, this);
+}
+
+Watchdog::~Watchdog() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cancelled = true;
+    }
+    m_cancel.notify_one();
+    m_thread.join();
+}
+
+bool Watchdog::hasFired() const {
+    return m_fired.load(std::memory_order_relaxed);
+}
+
+void Watchdog::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if(!m_cancel.wait_until(lock, m_deadline, [this] { return m_cancelled; })) {
+        m_fired.store(true, std::memory_order_relaxed);
+        m_ctx.stop();
+    }
+}
@@ -0,0 +1,54 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_WATCHDOG_H
+#define OTHELLOPROJECT_CPP_WATCHDOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "SearchContext.h"
+
+/**
+ * Enforces a hard deadline on a search from a separate thread. If the deadline passes before the
+ * watchdog is destroyed, it calls stop() on the context. The search itself never has to read the
+ * clock for this to work, so even a node that takes unexpectedly long cannot overrun the deadline
+ * by more than the time it takes to unwind.
+ */
+class Watchdog {
+public:
+    /**
+     * Starts watching immediately.
+     * @param ctx The search to stop.
+     * @param hardDeadline Point in time at which the search is stopped.
+     */
+    Watchdog(SearchContext &ctx, SearchContext::Clock::time_point hardDeadline);
+    /**
+     * Cancels the watchdog and joins its thread.
+     */
+    ~Watchdog();
+
+    Watchdog(const Watchdog &) = delete;
+    Watchdog &operator=(const Watchdog &) = delete;
+
+    /**
+     * @return True if the deadline was hit and the search was stopped by the watchdog.
+     */
+    bool hasFired() const;
+
+private:
+    SearchContext &m_ctx;
+    SearchContext::Clock::time_point m_deadline;
+    std::mutex m_mutex;
+    std::condition_variable m_cancel;
+    bool m_cancelled;
+    std::atomic<bool> m_fired;
+    std::thread m_thread;
+
+    void run();
+};
+
+#endif //OTHELLOPROJECT_CPP_WATCHDOG_H
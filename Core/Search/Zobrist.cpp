@@ -0,0 +1,61 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "Zobrist.h"
+
+#include <array>
+
+#include "../Bits.h"
+
+namespace {
+
+// Changing the seed invalidates every snapshot on disk (their signature no longer matches).
+constexpr uint64_t ZOBRIST_SEED = 0x4F5448454C4C4F31ULL;
+
+constexpr uint64_t splitMix64(uint64_t &state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr std::array<uint64_t, 128> KEYS = [] {
+    std::array<uint64_t, 128> keys{};
+    uint64_t state = ZOBRIST_SEED;
+    for(uint64_t &key : keys) {
+        key = splitMix64(state);
+    }
+    return keys;
+}();
+
+}
+
+const std::array<std::array<uint64_t, 64>, 2> Zobrist::DISC_KEYS = [] {
+    std::array<std::array<uint64_t, 64>, 2> keys{};
+    for(int pos = 0; pos < 64; pos++) {
+        keys[0][pos] = KEYS[pos];
+        keys[1][pos] = KEYS[64 + pos];
+    }
+    return keys;
+}();
+
+
+uint64_t Zobrist::compute(uint64_t player, uint64_t opponent) {
+    uint64_t key = 0;
+    Bits::forEach(player, [&](int pos) {
+        key ^= DISC_KEYS[0][pos];
+    });
+    Bits::forEach(opponent, [&](int pos) {
+        key ^= DISC_KEYS[1][pos];
+    });
+    return key;
+}
+
+uint64_t Zobrist::getSignature() {
+    uint64_t signature = 0;
+    for(uint64_t key : KEYS) {
+        signature = (signature ^ key) * 0x100000001B3ULL;
+    }
+    return signature;
+}
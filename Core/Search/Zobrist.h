@@ -0,0 +1,51 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_ZOBRIST_H
+#define OTHELLOPROJECT_CPP_ZOBRIST_H
+
+#include <array>
+#include <cstdint>
+
+#include "../Bits.h"
+
+/**
+ * Zobrist keys for hashing positions. A position's key is the XOR of one key per occupied square,
+ * one set for the discs of the side to move and one for the other side's. The side to move is
+ * implied, and a position has the same key whichever player a search is for.
+ *
+ * The keys come from a fixed seed, so they are the same in every process: keys written to a
+ * transposition table snapshot stay valid when it is loaded again.
+ */
+class Zobrist {
+public:
+    /**
+     * DISC_KEYS[0][pos] for a disc of the side to move on pos, DISC_KEYS[1][pos] for the other side's.
+     */
+    static const std::array<std::array<uint64_t, 64>, 2> DISC_KEYS;
+
+    /**
+     * Computes the key of a position from scratch.
+     * @param player Discs of the side to move.
+     */
+    static uint64_t compute(uint64_t player, uint64_t opponent);
+    /**
+     * @param side Set of the discs of the player who moves: 0 in the key of the position before the move,
+     *             1 in the key of the position after it (whose side to move is the other player).
+     * @return What a move changes in the key: the placed disc and the flipped discs.
+     */
+    static inline uint64_t moveDelta(int side, int pos, uint64_t flips) {
+        uint64_t delta = DISC_KEYS[side][pos];
+        Bits::forEach(flips, [&](int flipped) {
+            delta ^= DISC_KEYS[0][flipped] ^ DISC_KEYS[1][flipped];
+        });
+        return delta;
+    }
+    /**
+     * @return A digest of all keys, recorded in snapshots to reject files hashed with other keys.
+     */
+    static uint64_t getSignature();
+};
+
+#endif //OTHELLOPROJECT_CPP_ZOBRIST_H
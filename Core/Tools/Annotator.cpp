@@ -0,0 +1,229 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "Annotator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "../Bits.h"
+#include "../Logger.h"
+#include "../Utils.h"
+#include "../OthelloGame/OthelloGameBoard.h"
+#include "../Records/GameRecordReader.h"
+#include "../Search/TranspositionTable.h"
+
+namespace {
+
+std::string moveName(int pos) {
+    return pos < 0 ? "pass" : Utils::posToSquare(pos);
+}
+
+OthelloGameBoard boardFor(const Config &cfg, int color, uint64_t player, uint64_t opponent) {
+    BitBoard playerBoard(color), opponentBoard(-color);
+    playerBoard.setBits(player);
+    opponentBoard.setBits(opponent);
+    return OthelloGameBoard(cfg, color, playerBoard, opponentBoard);
+}
+
+// Score of a position for the side to move. A side without moves passes, a finished game is scored as it stands.
+int searchPosition(const Config &cfg, int color, uint64_t player, uint64_t opponent, const SearchLimits &limits,
+                   SearchContext &ctx, GameAnnotation &annotation, PlyAnnotation *ply = nullptr) {
+    OthelloGameBoard board = boardFor(cfg, color, player, opponent);
+    if(OthelloGameBoard::generateMoveMask(player, opponent) == 0) {
+        if(OthelloGameBoard::generateMoveMask(opponent, player) == 0) {
+            return board.evaluate();
+        }
+        return -searchPosition(cfg, -color, opponent, player, limits, ctx, annotation);
+    }
+
+    ctx.reset();
+    Move best = board.selectMove(color, limits, ctx);
+    const SearchInfo &info = board.getLastSearchInfo();
+    annotation.nodes += info.nodes;
+    annotation.timeMs += info.timeMs;
+    if(ply != nullptr) {
+        ply->best = best.getPos();
+        ply->depth = info.depth;
+    }
+    return info.score;
+}
+
+}
+
+GameAnnotation Annotator::annotate(const Config &cfg, const GameRecord &game, const SearchLimits &limits,
+                                   TranspositionTable *tt) {
+    GameAnnotation annotation;
+    size_t plies = game.moves.size();
+
+    // Forward replay: the position before every ply, and the final one.
+    std::vector<uint64_t> black(plies + 1), white(plies + 1);
+    uint64_t b = 0x0000000810000000ULL, w = 0x0000001008000000ULL;
+    for(size_t ply = 0; ply < plies; ply++) {
+        black[ply] = b;
+        white[ply] = w;
+
+        int color = ply % 2 == 0 ? BLACK : WHITE;
+        uint64_t &own = color == BLACK ? b : w;
+        uint64_t &other = color == BLACK ? w : b;
+        uint64_t legal = OthelloGameBoard::generateMoveMask(own, other);
+        int pos = game.moves[ply];
+
+        bool ok = pos == RECORD_PASS ? legal == 0 : ((1ULL << pos) & legal) != 0;
+        if(!ok) {
+            annotation.valid = false;
+            return annotation;
+        }
+        if(pos != RECORD_PASS) {
+            uint64_t flips = OthelloGameBoard::getFlips(own, other, pos);
+            own |= flips | (1ULL << pos);
+            other &= ~flips;
+        }
+    }
+    black[plies] = b;
+    white[plies] = w;
+    annotation.blackDiscs = Bits::popcount(b);
+    annotation.whiteDiscs = Bits::popcount(w);
+    annotation.plies.resize(plies);
+
+    SearchContext ctx;
+    ctx.setTable(tt);
+    ctx.setParams(cfg.getSearchParams());
+
+    // Backwards, so that every search finds the later positions in the table.
+    for(size_t i = plies; i-- > 0;) {
+        PlyAnnotation &ply = annotation.plies[i];
+        ply.color = i % 2 == 0 ? BLACK : WHITE;
+        ply.played = game.moves[i] == RECORD_PASS ? -1 : game.moves[i];
+        uint64_t player = ply.color == BLACK ? black[i] : white[i];
+        uint64_t opponent = ply.color == BLACK ? white[i] : black[i];
+
+        if(ply.played < 0) {
+            // Nothing to choose: the position is worth what the forced pass leads to.
+            ply.score = i + 1 < plies ? -annotation.plies[i + 1].score :
+                        boardFor(cfg, ply.color, player, opponent).evaluate();
+            ply.playedScore = ply.score;
+            continue;
+        }
+
+        ply.score = searchPosition(cfg, ply.color, player, opponent, limits, ctx, annotation, &ply);
+        ply.playedScore = ply.score;
+
+        if(ply.best != ply.played) {
+            // The move played, one ply shallower, so that both scores come from the same horizon; the
+            // search just made leaves most of that tree in the table. Scores from the search of the next
+            // position would be a ply deeper and swing with the parity of the depth.
+            SearchLimits child;
+            child.depth = ply.depth - 1;
+            uint64_t nextPlayer = ply.color == BLACK ? white[i + 1] : black[i + 1];
+            uint64_t nextOpponent = ply.color == BLACK ? black[i + 1] : white[i + 1];
+            ply.playedScore = child.depth > 0 ?
+                    -searchPosition(cfg, -ply.color, nextPlayer, nextOpponent, child, ctx, annotation) :
+                    -boardFor(cfg, -ply.color, nextPlayer, nextOpponent).evaluate();
+            ply.loss = std::max(0, ply.score - ply.playedScore);
+        }
+    }
+
+    return annotation;
+}
+
+std::vector<GameRecord> Annotator::loadGames(const std::string &path) {
+    std::vector<GameRecord> games;
+    auto add = [&](const GameRecordView &view) { games.push_back(view.toRecord()); };
+
+    // A directory cannot be mapped as a file.
+    if(GameRecordReader::forEach(path, add) < 0) {
+        GameRecordReader::forEachInDirectory(path, add);
+    }
+    return games;
+}
+
+std::vector<std::string> Annotator::format(const GameAnnotation &annotation, int mistakeLoss) {
+    std::vector<std::string> lines;
+    if(!annotation.valid) {
+        lines.emplace_back("illegal move in record, not annotated");
+        return lines;
+    }
+
+    int64_t loss[2] = { 0, 0 };
+    int moves[2] = { 0, 0 }, mistakes[2] = { 0, 0 };
+
+    for(size_t i = 0; i < annotation.plies.size(); i++) {
+        const PlyAnnotation &ply = annotation.plies[i];
+        int side = ply.color == BLACK ? 0 : 1;
+        std::string line = std::to_string(i + 1) + ". " + (ply.color == BLACK ? "B " : "W ") + moveName(ply.played);
+
+        if(ply.played >= 0) {
+            moves[side]++;
+            loss[side] += ply.loss;
+            line += ": score " + std::to_string(ply.score) + " depth " + std::to_string(ply.depth);
+            if(ply.best != ply.played) {
+                line += ", best " + moveName(ply.best) + ", played " + std::to_string(ply.playedScore) +
+                        ", loss " + std::to_string(ply.loss);
+            }
+            if(ply.loss >= mistakeLoss) {
+                mistakes[side]++;
+                line += " (mistake)";
+            }
+        }
+        lines.push_back(line);
+    }
+
+    for(int side = 0; side < 2; side++) {
+        lines.push_back(std::string(side == 0 ? "Black" : "White") + ": average loss " +
+                        std::to_string(moves[side] == 0 ? 0 : loss[side] / moves[side]) + ", mistakes " +
+                        std::to_string(mistakes[side]));
+    }
+    lines.push_back("Final " + std::to_string(annotation.blackDiscs) + "-" + std::to_string(annotation.whiteDiscs) +
+                    ", " + std::to_string(annotation.nodes) + " nodes in " + std::to_string(annotation.timeMs) + "ms");
+    return lines;
+}
+
+void Annotator::run(const Config &cfg, const std::vector<GameRecord> &games, const AnnotateOptions &options) {
+    int threads = options.threads > 0 ? options.threads : (int) std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, (int) games.size()));
+
+    // Thousands of searches would each log their iterations.
+    LogLevel level = Logger::getLevel();
+    Logger::setLevel(LogLevel::Warn);
+
+    std::vector<GameAnnotation> annotations(games.size());
+    std::vector<bool> done(games.size(), false);
+    size_t nextToWrite = 0;
+    std::mutex mutex;
+    std::atomic<size_t> next(0);
+
+    auto worker = [&] {
+        TranspositionTable tt(cfg.getHashMb());
+        for(size_t i; (i = next.fetch_add(1)) < games.size();) {
+            GameAnnotation annotation = annotate(cfg, games[i], options.limits, &tt);
+
+            // Games are written in order: whoever completes the oldest outstanding game writes
+            // it and every finished game after it.
+            std::lock_guard<std::mutex> lock(mutex);
+            annotations[i] = std::move(annotation);
+            done[i] = true;
+            for(; nextToWrite < games.size() && done[nextToWrite]; nextToWrite++) {
+                Logger::writeProtocol("Game " + std::to_string(nextToWrite + 1) + "/" + std::to_string(games.size()));
+                for(const std::string &line : format(annotations[nextToWrite], options.mistakeLoss)) {
+                    Logger::writeProtocol(line);
+                }
+                annotations[nextToWrite] = GameAnnotation();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for(int t = 1; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for(std::thread &thread : pool) {
+        thread.join();
+    }
+
+    Logger::setLevel(level);
+}
@@ -0,0 +1,103 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_ANNOTATOR_H
+#define OTHELLOPROJECT_CPP_ANNOTATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Config.h"
+#include "../Records/GameRecord.h"
+#include "../Search/SearchLimits.h"
+
+class TranspositionTable;
+
+/**
+ * Analysis of one ply. Scores are engine scores from the mover's point of view.
+ */
+struct PlyAnnotation {
+    int color = 0;
+    /**
+     * Board position of the move played, or -1 for a pass.
+     */
+    int played = -1;
+    /**
+     * The engine's choice and its score. For a pass, the score of the position.
+     */
+    int best = -1;
+    int score = 0;
+    /**
+     * Score of the move played, searched one ply shallower than score so that the two compare.
+     */
+    int playedScore = 0;
+    /**
+     * score - playedScore, at least 0. Always 0 when the engine's choice was played.
+     */
+    int loss = 0;
+    int depth = 0;
+};
+
+struct GameAnnotation {
+    /**
+     * False if the record holds an illegal move; nothing is annotated then.
+     */
+    bool valid = true;
+    std::vector<PlyAnnotation> plies;
+    int blackDiscs = 0;
+    int whiteDiscs = 0;
+    uint64_t nodes = 0;
+    uint64_t timeMs = 0;
+};
+
+struct AnnotateOptions {
+    /**
+     * Per position. No limit at all means the Config move time.
+     */
+    SearchLimits limits;
+    /**
+     * Games analysed at once, 0 for one per core. Each has its own transposition table.
+     */
+    int threads = 0;
+    /**
+     * Moves losing at least this much are marked as mistakes.
+     */
+    int mistakeLoss = 200;
+};
+
+/**
+ * Post-game review: annotates every ply of recorded games with the engine's score, its best move
+ * and the score lost by the move actually played.
+ *
+ * A game is analysed backwards from its last position, with the transposition table kept from
+ * one position to the one before it. Positions near the end are solved exactly first, and their
+ * results are then found in the table by the searches of the earlier positions. When the move
+ * played is not the engine's choice, the position it led to is searched one ply shallower, mostly
+ * from the table the search just filled.
+ */
+class Annotator {
+public:
+    /**
+     * Annotates several games concurrently and writes each one out, in order, as soon as it and all
+     * games before it are done.
+     */
+    static void run(const Config &cfg, const std::vector<GameRecord> &games, const AnnotateOptions &options);
+    /**
+     * Annotates a single game with the given table, which is kept between its positions.
+     */
+    static GameAnnotation annotate(const Config &cfg, const GameRecord &game, const SearchLimits &limits,
+                                   TranspositionTable *tt);
+    /**
+     * @param path A game record file, or a directory of them.
+     * @return Every game in it, in file order.
+     */
+    static std::vector<GameRecord> loadGames(const std::string &path);
+    /**
+     * @return The annotated game as text lines.
+     */
+    static std::vector<std::string> format(const GameAnnotation &annotation, int mistakeLoss);
+};
+
+#endif //OTHELLOPROJECT_CPP_ANNOTATOR_H
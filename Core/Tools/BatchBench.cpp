@@ -0,0 +1,117 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "BatchBench.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../Bits.h"
+#include "../Logger.h"
+#include "../Env/BatchEnv.h"
+#include "../OthelloGame/OthelloGameBoard.h"
+
+namespace {
+
+uint64_t nextRandom(uint64_t &state) {
+    // xorshift64
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+int8_t pickRandom(uint64_t legal, uint64_t &rng) {
+    if(legal == 0) {
+        return BATCH_PASS;
+    }
+
+    int k = (int) (nextRandom(rng) % (uint64_t) Bits::popcount(legal));
+    while(k-- > 0) {
+        legal = Bits::clearLowest(legal);
+    }
+    return (int8_t) Bits::lowest(legal);
+}
+
+}
+
+BatchBenchResult BatchBench::run(int games, uint64_t seed) {
+    BatchBenchResult result;
+    if(games <= 0) {
+        return result;
+    }
+
+    size_t n = (size_t) games;
+    std::vector<uint64_t> player(n), opponent(n), legal(n);
+    std::vector<uint64_t> expectPlayer(n), expectOpponent(n);
+    std::vector<int8_t> moves(n), reward(n);
+    std::vector<uint8_t> done(n);
+    GameBatch batch{player.data(), opponent.data(), n};
+
+    uint64_t rng = seed | 1;
+    auto timed = [&](auto &&call) {
+        PerfSample perfBefore = PerfCounters::read();
+        auto start = std::chrono::steady_clock::now();
+        call();
+        result.perf += PerfCounters::read().since(perfBefore);
+        result.timeUs += std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+    };
+
+    timed([&] { BatchEnv::reset(batch); });
+
+    size_t finished = 0;
+    while(finished < n) {
+        timed([&] {
+            BatchEnv::legalMoves(batch, legal.data());
+            BatchEnv::terminal(batch, legal.data(), done.data(), reward.data());
+        });
+
+        finished = 0;
+        for(size_t i = 0; i < n; i++) {
+            if(legal[i] != OthelloGameBoard::generateMoveMask(player[i], opponent[i])) {
+                result.mismatches++;
+            }
+
+            // Finished games just keep passing.
+            finished += done[i];
+            moves[i] = done[i] ? BATCH_PASS : pickRandom(legal[i], rng);
+            result.moves += !done[i] && moves[i] != BATCH_PASS;
+        }
+
+        for(size_t i = 0; i < n; i++) {
+            uint64_t flips = 0, bit = 0;
+            if(moves[i] != BATCH_PASS) {
+                flips = OthelloGameBoard::getFlips(player[i], opponent[i], moves[i]);
+                bit = 1ULL << moves[i];
+            }
+            expectPlayer[i] = opponent[i] & ~flips;
+            expectOpponent[i] = player[i] | flips | bit;
+        }
+
+        timed([&] { BatchEnv::applyMoves(batch, moves.data()); });
+
+        for(size_t i = 0; i < n; i++) {
+            if(player[i] != expectPlayer[i] || opponent[i] != expectOpponent[i]) {
+                result.mismatches++;
+            }
+        }
+    }
+
+    result.games = n;
+    return result;
+}
+
+void BatchBench::report(const BatchBenchResult &result) {
+    uint64_t perSecond = result.timeUs == 0 ? 0 : result.moves * 1000000 / result.timeUs;
+
+    Logger::writeProtocol("Batch (" + std::string(BatchEnv::getKernelName()) + "): " +
+                          std::to_string(result.games) + " games, " + std::to_string(result.moves) + " moves in " +
+                          std::to_string(result.timeUs / 1000) + "ms, " + std::to_string(perSecond) +
+                          " moves/s, " + std::to_string(result.mismatches) + " mismatches");
+    if(PerfCounters::isOpen()) {
+        Logger::writeProtocol("Counters: " + result.perf.describe(result.moves, "move"));
+    }
+}
@@ -0,0 +1,46 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_BATCHBENCH_H
+#define OTHELLOPROJECT_CPP_BATCHBENCH_H
+
+#include <cstdint>
+
+#include "../PerfCounters.h"
+
+/**
+ * Outcome of a BatchBench run.
+ */
+struct BatchBenchResult {
+    uint64_t games = 0;
+    uint64_t moves = 0;
+    /**
+     * Time spent inside BatchEnv calls only.
+     */
+    uint64_t timeUs = 0;
+    /**
+     * Number of legal masks or positions that differed from OthelloGameBoard.
+     */
+    uint64_t mismatches = 0;
+    /**
+     * Performance counters over the same BatchEnv calls, if PerfCounters are open.
+     */
+    PerfSample perf;
+};
+
+/**
+ * Plays random games through BatchEnv, checking every step against the scalar
+ * OthelloGameBoard move generator, and measures the batch throughput.
+ */
+class BatchBench {
+public:
+    /**
+     * @param games Number of games, all played in one batch.
+     * @param seed Seed for the random move choice.
+     */
+    static BatchBenchResult run(int games, uint64_t seed = 1);
+    static void report(const BatchBenchResult &result);
+};
+
+#endif //OTHELLOPROJECT_CPP_BATCHBENCH_H
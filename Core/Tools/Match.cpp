@@ -0,0 +1,167 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "Match.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "../Bits.h"
+#include "../Logger.h"
+#include "../OthelloGame/OthelloGameBoard.h"
+#include "../Search/DfpnSolver.h"
+#include "../Search/Mcts.h"
+#include "../Search/TranspositionTable.h"
+
+namespace {
+
+/**
+ * One side of a game, set up like OthelloEngine: a table and a solver kept for the whole
+ * game, and a clock of the Config's game time that every move takes its share of.
+ */
+struct GameSide {
+    const Config &cfg;
+    TranspositionTable tt;
+    DfpnSolver solver;
+    SearchContext ctx;
+    int64_t remainingMs;
+
+    explicit GameSide(const Config &cfg) : cfg(cfg), tt(cfg.getHashMb()),
+                                           remainingMs((int64_t) cfg.getGameTime() * 1000) {
+        ctx.setTable(&tt);
+        ctx.setSolver(&solver);
+        ctx.setParams(cfg.getSearchParams());
+    }
+};
+
+}
+
+double MatchResult::getScore() const {
+    int games = this->wins + this->losses + this->draws;
+    return games == 0 ? 0.0 : (this->wins + 0.5 * this->draws) / games;
+}
+
+MatchResult Match::play(const Config &cfg, EngineType engine, EngineType opponent, int games) {
+    MatchResult result;
+
+    std::unique_ptr<Mcts> mcts;
+    if(engine == EngineType::Mcts || opponent == EngineType::Mcts) {
+        mcts = std::make_unique<Mcts>(MCTS_DEFAULT_NODES, cfg.getThreads());
+    }
+
+    for(int game = 0; game < games; game++) {
+        int engineColor = game % 2 == 0 ? BLACK : WHITE;
+        OthelloGameBoard board(cfg, BLACK, BitBoard(BLACK), BitBoard(WHITE));
+        GameSide engineSide(cfg), opponentSide(cfg);
+
+        int color = BLACK;
+        while(!board.isGameComplete()) {
+            bool engineTurn = color == engineColor;
+            EngineType type = engineTurn ? engine : opponent;
+            GameSide &side = engineTurn ? engineSide : opponentSide;
+
+            // Both engines play on the same clock, each move getting its share of what is left.
+            int64_t budgetMs = std::max<int64_t>(1, side.remainingMs / cfg.getSearchParams().moveTimeDivisor);
+            Move move;
+            if(type == EngineType::Mcts) {
+                move = mcts->selectMove(board, color, budgetMs);
+            } else {
+                SearchLimits limits;
+                limits.moveTimeMs = budgetMs;
+                side.ctx.reset();
+                move = board.selectMove(color, limits, side.ctx);
+            }
+            const SearchInfo &info = type == EngineType::Mcts ? mcts->getLastSearchInfo() : board.getLastSearchInfo();
+            side.remainingMs -= (int64_t) info.timeMs;
+
+            (engineTurn ? result.engineNodes : result.opponentNodes) += info.nodes;
+            (engineTurn ? result.engineTimeMs : result.opponentTimeMs) += info.timeMs;
+
+            if(!move.isPass()) {
+                board.applyMove(board.getForColor(color), move);
+            }
+            color = -color;
+        }
+
+        int diff = board.countPieces(engineColor) - board.countPieces(-engineColor);
+        result.discDiff += diff;
+        if(diff > 0) {
+            result.wins++;
+        } else if(diff < 0) {
+            result.losses++;
+        } else {
+            result.draws++;
+        }
+
+        Logger::writeProtocol("Game " + std::to_string(game + 1) + "/" + std::to_string(games) + ": " +
+                              getEngineName(engine) + " as " + (engineColor == BLACK ? "black" : "white") +
+                              ", disc differential " + std::to_string(diff));
+    }
+
+    return result;
+}
+
+int Match::playGame(const Config &black, const Config &white, uint64_t blackBits, uint64_t whiteBits, int sideToMove) {
+    GameSide blackSide(black), whiteSide(white);
+    int color = sideToMove;
+    while(true) {
+        uint64_t &own = color == BLACK ? blackBits : whiteBits;
+        uint64_t &other = color == BLACK ? whiteBits : blackBits;
+
+        if(OthelloGameBoard::generateMoveMask(own, other) == 0) {
+            if(OthelloGameBoard::generateMoveMask(other, own) == 0) {
+                break;
+            }
+            color = -color;
+            continue;
+        }
+
+        // A fresh board for every move, so that the mover searches and evaluates with its own settings.
+        GameSide &side = color == BLACK ? blackSide : whiteSide;
+        BitBoard player(color), opponent(-color);
+        player.setBits(own);
+        opponent.setBits(other);
+        OthelloGameBoard board(side.cfg, color, player, opponent);
+
+        // The move gets its share of what is left on the clock, so spending more now leaves less for later.
+        SearchLimits limits;
+        limits.moveTimeMs = std::max<int64_t>(1, side.remainingMs / side.cfg.getSearchParams().moveTimeDivisor);
+        side.ctx.reset();
+        int pos = board.selectMove(color, limits, side.ctx).getPos();
+        side.remainingMs -= (int64_t) side.ctx.getElapsedMs();
+        uint64_t flips = OthelloGameBoard::getFlips(own, other, pos);
+        own |= flips | (1ULL << pos);
+        other &= ~flips;
+        color = -color;
+    }
+
+    return Bits::popcount(blackBits) - Bits::popcount(whiteBits);
+}
+
+void Match::report(const MatchResult &result, EngineType engine, EngineType opponent) {
+    auto perSecond = [](uint64_t nodes, uint64_t ms) {
+        return std::to_string(ms == 0 ? 0 : nodes * 1000 / ms);
+    };
+
+    Logger::writeProtocol(std::string(getEngineName(engine)) + " vs " + getEngineName(opponent) + ": +" +
+                          std::to_string(result.wins) + " -" + std::to_string(result.losses) + " =" +
+                          std::to_string(result.draws) + ", score " +
+                          std::to_string((int) (result.getScore() * 100)) + "%, disc differential " +
+                          std::to_string(result.discDiff));
+    Logger::writeProtocol(std::string(getEngineName(engine)) + ": " +
+                          perSecond(result.engineNodes, result.engineTimeMs) + " nodes/s");
+    Logger::writeProtocol(std::string(getEngineName(opponent)) + ": " +
+                          perSecond(result.opponentNodes, result.opponentTimeMs) + " nodes/s");
+}
+
+const char *Match::getEngineName(EngineType engine) {
+    switch(engine) {
+        case EngineType::Mcts:
+            return "mcts";
+        case EngineType::AlphaBeta:
+        default:
+            return "alphabeta";
+    }
+}
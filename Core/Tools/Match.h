@@ -0,0 +1,64 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_MATCH_H
+#define OTHELLOPROJECT_CPP_MATCH_H
+
+#include <cstdint>
+
+#include "../Config.h"
+
+/**
+ * Outcome of a Match, from the point of view of the engine under test.
+ */
+struct MatchResult {
+    int wins = 0;
+    int losses = 0;
+    int draws = 0;
+    /**
+     * Total disc differential over all games.
+     */
+    int discDiff = 0;
+
+    // Search totals per side. Nodes are playouts for MCTS.
+    uint64_t engineNodes = 0;
+    uint64_t engineTimeMs = 0;
+    uint64_t opponentNodes = 0;
+    uint64_t opponentTimeMs = 0;
+
+    /**
+     * @return Points scored by the engine under test (win = 1, draw = 0.5) divided by games played.
+     */
+    double getScore() const;
+};
+
+/**
+ * Plays in-process games between two engines on the same game clock, alternating colors.
+ */
+class Match {
+public:
+    /**
+     * @param cfg Game time, search settings and thread count used by both sides. Alpha-beta sides get
+     * their own transposition table and solver for each game, as in playGame.
+     * @param engine The engine under test.
+     * @param opponent The reference engine.
+     * @param games Number of games. The engine under test plays black in even-numbered games.
+     */
+    static MatchResult play(const Config &cfg, EngineType engine, EngineType opponent, int games);
+    /**
+     * Logs a summary of the result, including nodes (or playouts) per second for both sides.
+     */
+    static void report(const MatchResult &result, EngineType engine, EngineType opponent);
+    /**
+     * Plays one alpha-beta game to the end, each side searching with its own configuration, its own
+     * transposition table and proof-number solver, and a clock of its Config's game time. Each move
+     * gets the time left over SearchParams::moveTimeDivisor. Safe to call from several threads at once.
+     * @param sideToMove Color to move first in the given position.
+     * @return Disc differential from black's point of view.
+     */
+    static int playGame(const Config &black, const Config &white, uint64_t blackBits, uint64_t whiteBits, int sideToMove);
+    static const char *getEngineName(EngineType engine);
+};
+
+#endif //OTHELLOPROJECT_CPP_MATCH_H
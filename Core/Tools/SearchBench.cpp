@@ -0,0 +1,350 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "SearchBench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "../AllocTracker.h"
+#include "../Bits.h"
+#include "../Logger.h"
+#include "../Utils.h"
+#include "../OthelloGame/OthelloGameBoard.h"
+#include "../Search/DfpnSolver.h"
+#include "../Search/TranspositionTable.h"
+
+namespace {
+
+uint64_t nextRandom(uint64_t &state) {
+    // xorshift64
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Somewhere between the opening and the late midgame. False unless black is to move and can move.
+bool randomPosition(uint64_t &rng, uint64_t &black, uint64_t &white) {
+    int plies = 2 * (4 + (int) (nextRandom(rng) % 16));
+    black = 0x0000000810000000ULL;
+    white = 0x0000001008000000ULL;
+    bool blackToMove = true;
+
+    for(int ply = 0; ply < plies; ply++) {
+        uint64_t &player = blackToMove ? black : white;
+        uint64_t &opponent = blackToMove ? white : black;
+        uint64_t legal = OthelloGameBoard::generateMoveMask(player, opponent);
+
+        if(legal != 0) {
+            int k = (int) (nextRandom(rng) % (uint64_t) Bits::popcount(legal));
+            while(k-- > 0) {
+                legal = Bits::clearLowest(legal);
+            }
+            int pos = Bits::lowest(legal);
+            uint64_t flips = OthelloGameBoard::getFlips(player, opponent, pos);
+            player |= flips | (1ULL << pos);
+            opponent &= ~flips;
+        }
+        blackToMove = !blackToMove;
+    }
+
+    return blackToMove && OthelloGameBoard::generateMoveMask(black, white) != 0;
+}
+
+// A random game played until empties squares are left. False if it ended earlier or the side to move cannot move.
+bool randomEndgame(uint64_t &rng, int empties, uint64_t &player, uint64_t &opponent) {
+    player = 0x0000000810000000ULL;
+    opponent = 0x0000001008000000ULL;
+
+    while(64 - Bits::popcount(player | opponent) > empties) {
+        uint64_t legal = OthelloGameBoard::generateMoveMask(player, opponent);
+        if(legal == 0 && OthelloGameBoard::generateMoveMask(opponent, player) == 0) {
+            return false;
+        }
+
+        if(legal != 0) {
+            int k = (int) (nextRandom(rng) % (uint64_t) Bits::popcount(legal));
+            while(k-- > 0) {
+                legal = Bits::clearLowest(legal);
+            }
+            int pos = Bits::lowest(legal);
+            uint64_t flips = OthelloGameBoard::getFlips(player, opponent, pos);
+            player |= flips | (1ULL << pos);
+            opponent &= ~flips;
+        }
+        std::swap(player, opponent);
+    }
+
+    return OthelloGameBoard::generateMoveMask(player, opponent) != 0;
+}
+
+// Fail-soft negamax on the final disc difference, without any move ordering or table.
+int solveReference(uint64_t player, uint64_t opponent, int alpha, int beta, uint64_t &nodes) {
+    nodes++;
+    uint64_t legal = OthelloGameBoard::generateMoveMask(player, opponent);
+    if(legal == 0) {
+        if(OthelloGameBoard::generateMoveMask(opponent, player) == 0) {
+            return Bits::popcount(player) - Bits::popcount(opponent);
+        }
+        return -solveReference(opponent, player, -beta, -alpha, nodes);
+    }
+
+    int best = -64;
+    for(; legal != 0; legal = Bits::clearLowest(legal)) {
+        int pos = Bits::lowest(legal);
+        uint64_t flips = OthelloGameBoard::getFlips(player, opponent, pos);
+        int score = -solveReference(opponent & ~flips, player | flips | (1ULL << pos), -beta, -alpha, nodes);
+        best = std::max(best, score);
+        alpha = std::max(alpha, score);
+        if(alpha >= beta) {
+            break;
+        }
+    }
+    return best;
+}
+
+OthelloGameBoard makeBoard(const Config &cfg, uint64_t black, uint64_t white) {
+    BitBoard blackBoard(BLACK), whiteBoard(WHITE);
+    blackBoard.setBits(black);
+    whiteBoard.setBits(white);
+    return OthelloGameBoard(cfg, BLACK, blackBoard, whiteBoard);
+}
+
+}
+
+SearchBenchResult SearchBench::run(const Config &cfg, int depth, int positions, uint64_t seed, TreeRecorder *recorder) {
+    SearchBenchResult result;
+    uint64_t rng = seed | 1;
+
+    TranspositionTable tt(cfg.getHashMb());
+    SearchContext ctx;
+    ctx.setTable(&tt);
+    ctx.setRecorder(recorder);
+    ctx.setParams(cfg.getSearchParams());
+
+    SearchLimits limits;
+    limits.depth = depth;
+
+    while(result.positions < positions) {
+        uint64_t black, white;
+        if(!randomPosition(rng, black, white)) {
+            continue;
+        }
+
+        OthelloGameBoard board = makeBoard(cfg, black, white);
+
+        // Every position starts from an empty table, so results do not depend on the order.
+        tt.clear();
+        ctx.reset();
+        PerfSample before = PerfCounters::read();
+        board.selectMove(BLACK, limits, ctx);
+        result.perf += PerfCounters::read().since(before);
+
+        const SearchInfo &info = board.getLastSearchInfo();
+        const SearchStats &stats = ctx.getStats();
+        result.positions++;
+        result.nodes += info.nodes;
+        result.timeMs += info.timeMs;
+        result.scoreSum += info.score;
+        result.stats.ttCutoffs += stats.ttCutoffs;
+        result.stats.etcProbes += stats.etcProbes;
+        result.stats.etcCutoffs += stats.etcCutoffs;
+        result.stats.lmrReductions += stats.lmrReductions;
+        result.stats.lmrResearches += stats.lmrResearches;
+        result.stats.lazyEvals += stats.lazyEvals;
+        result.stats.lazyCheapExits += stats.lazyCheapExits;
+        result.stats.lazyMobilityExits += stats.lazyMobilityExits;
+    }
+
+    return result;
+}
+
+void SearchBench::report(const SearchBenchResult &result) {
+    uint64_t perSecond = result.timeMs == 0 ? 0 : result.nodes * 1000 / result.timeMs;
+    const SearchStats &stats = result.stats;
+
+    Logger::writeProtocol("Search: " + std::to_string(result.positions) + " positions, " +
+                          std::to_string(result.nodes) + " nodes in " + std::to_string(result.timeMs) + "ms, " +
+                          std::to_string(perSecond) + " nodes/s, score sum " + std::to_string(result.scoreSum));
+    Logger::writeProtocol("TT cutoffs " + std::to_string(stats.ttCutoffs) + ", ETC cutoffs " +
+                          std::to_string(stats.etcCutoffs) + " of " + std::to_string(stats.etcProbes) +
+                          " nodes, LMR " + std::to_string(stats.lmrReductions) + " reductions, " +
+                          std::to_string(stats.lmrResearches) + " re-searched");
+    Logger::writeProtocol("Lazy eval: " + std::to_string(stats.lazyEvals) + " leaves, " +
+                          std::to_string(stats.lazyCheapExits) + " cut before mobility, " +
+                          std::to_string(stats.lazyMobilityExits) + " after one side's mobility, " +
+                          std::to_string(stats.lazyEvals - stats.lazyCheapExits - stats.lazyMobilityExits) +
+                          " evaluated in full");
+    if(PerfCounters::isOpen()) {
+        Logger::writeProtocol("Counters: " + result.perf.describe(result.nodes));
+    }
+}
+
+AllocCheckResult SearchBench::checkAllocations(const Config &cfg, int depth, int positions, uint64_t seed) {
+    AllocCheckResult result;
+    uint64_t rng = seed | 1;
+
+    TranspositionTable tt(cfg.getHashMb());
+    SearchContext ctx;
+    ctx.setTable(&tt);
+    ctx.setParams(cfg.getSearchParams());
+
+    SearchLimits limits;
+    limits.depth = depth;
+
+    AllocTracker::reset();
+    AllocTracker::start();
+
+    while(result.positions < positions) {
+        uint64_t black, white;
+        if(!randomPosition(rng, black, white)) {
+            continue;
+        }
+
+        // The first search of a position is the warm-up. The second starts from the same empty
+        // table and has to search the same tree without allocating in it.
+        for(int pass = 0; pass < 2; pass++) {
+            AllocCounts before[(int) AllocPhase::Count];
+            for(int phase = 0; phase < (int) AllocPhase::Count; phase++) {
+                before[phase] = AllocTracker::getCounts((AllocPhase) phase);
+            }
+
+            OthelloGameBoard board = makeBoard(cfg, black, white);
+            tt.clear();
+            ctx.reset();
+            board.selectMove(BLACK, limits, ctx);
+
+            AllocCounts *counts = pass == 0 ? result.warmUp : result.measured;
+            for(int phase = 0; phase < (int) AllocPhase::Count; phase++) {
+                AllocCounts after = AllocTracker::getCounts((AllocPhase) phase);
+                counts[phase].allocations += after.allocations - before[phase].allocations;
+                counts[phase].bytes += after.bytes - before[phase].bytes;
+            }
+        }
+        result.positions++;
+    }
+
+    AllocTracker::stop();
+    return result;
+}
+
+bool SearchBench::reportAllocations(const AllocCheckResult &result) {
+    auto describe = [](const AllocCounts *counts) {
+        std::string s;
+        for(int phase = (int) AllocPhase::Setup; phase < (int) AllocPhase::Count; phase++) {
+            s += std::string(phase == (int) AllocPhase::Setup ? "" : ", ") + AllocTracker::getPhaseName((AllocPhase) phase) +
+                 " " + std::to_string(counts[phase].allocations) + " (" + std::to_string(counts[phase].bytes) + " bytes)";
+        }
+        return s;
+    };
+
+    // Only the tree search has to be allocation-free; setup and reporting run once per search or iteration.
+    const AllocCounts &tree = result.measured[(int) AllocPhase::Tree];
+    bool ok = tree.allocations == 0;
+
+    Logger::writeProtocol("Allocations over " + std::to_string(result.positions) + " positions, warm-up: " +
+                          describe(result.warmUp));
+    Logger::writeProtocol("Allocations over " + std::to_string(result.positions) + " positions, measured: " +
+                          describe(result.measured));
+    for(int thread = 0; thread < AllocTracker::getThreadCount(); thread++) {
+        AllocCounts total;
+        for(int phase = 0; phase < (int) AllocPhase::Count; phase++) {
+            AllocCounts counts = AllocTracker::getThreadCounts(thread, (AllocPhase) phase);
+            total.allocations += counts.allocations;
+            total.bytes += counts.bytes;
+        }
+        Logger::writeProtocol("Thread " + std::to_string(thread) + ": " + std::to_string(total.allocations) +
+                              " allocations (" + std::to_string(total.bytes) + " bytes)");
+    }
+    Logger::writeProtocol(ok ? "OK search tree is allocation-free"
+                             : "FAILED search tree allocated " + std::to_string(tree.allocations) + " times");
+    return ok;
+}
+
+SolverCheckResult SearchBench::checkSolver(const Config &cfg, int empties, int positions, int64_t timeMs, uint64_t seed) {
+    SolverCheckResult result;
+    result.empties = empties;
+    uint64_t rng = seed | 1;
+
+    DfpnSolver solver(cfg.getHashMb());
+    SearchContext ctx;
+
+    while(result.positions < positions) {
+        uint64_t player, opponent;
+        if(!randomEndgame(rng, empties, player, opponent)) {
+            continue;
+        }
+
+        // Every proof starts from an empty table, so that its cost is its own.
+        solver.clear();
+        ctx.reset();
+        PerfSample before = PerfCounters::read();
+        DfpnResult proof = solver.solve(player, opponent, SearchContext::now() + std::chrono::milliseconds(timeMs), ctx);
+        result.solverPerf += PerfCounters::read().since(before);
+        result.positions++;
+        result.solverNodes += proof.nodes;
+        result.solverTimeMs += proof.timeMs;
+        result.collections += proof.collections;
+
+        SearchContext::Clock::time_point start = SearchContext::now();
+        before = PerfCounters::read();
+        int score = solveReference(player, opponent, -1, 1, result.referenceNodes);
+        result.referencePerf += PerfCounters::read().since(before);
+        result.referenceTimeMs += (uint64_t) std::chrono::duration_cast<std::chrono::milliseconds>(
+                SearchContext::now() - start).count();
+        DfpnOutcome expected = score > 0 ? DfpnOutcome::Win : score == 0 ? DfpnOutcome::Draw : DfpnOutcome::Loss;
+
+        if(proof.outcome == DfpnOutcome::Unknown) {
+            result.unknown++;
+            continue;
+        }
+        result.wins += proof.outcome == DfpnOutcome::Win;
+        result.draws += proof.outcome == DfpnOutcome::Draw;
+        result.losses += proof.outcome == DfpnOutcome::Loss;
+
+        // The proving move has to achieve the outcome as well.
+        bool moveOk = true;
+        if(proof.outcome != DfpnOutcome::Loss) {
+            uint64_t flips = OthelloGameBoard::getFlips(player, opponent, proof.move);
+            uint64_t nodes = 0;
+            int after = -solveReference(opponent & ~flips, player | flips | (1ULL << proof.move), -1, 1, nodes);
+            moveOk = proof.outcome == DfpnOutcome::Win ? after > 0 : after == 0;
+        }
+
+        if(proof.outcome != expected || !moveOk) {
+            result.mismatches++;
+            Logger::log(LogLevel::Warn, "Solver mismatch: proved " + std::string(DfpnSolver::getOutcomeName(proof.outcome)) +
+                                        " with " + Utils::posToSquare(proof.move) + ", reference " +
+                                        DfpnSolver::getOutcomeName(expected) + " (" + std::to_string(player) + ", " +
+                                        std::to_string(opponent) + ")");
+        }
+    }
+
+    return result;
+}
+
+bool SearchBench::reportSolver(const SolverCheckResult &result) {
+    auto perSecond = [](uint64_t nodes, uint64_t ms) { return ms == 0 ? 0 : nodes * 1000 / ms; };
+
+    Logger::writeProtocol("Solver: " + std::to_string(result.positions) + " positions with " +
+                          std::to_string(result.empties) + " empties, " + std::to_string(result.wins) + " wins, " +
+                          std::to_string(result.draws) + " draws, " + std::to_string(result.losses) + " losses, " +
+                          std::to_string(result.unknown) + " unproven");
+    Logger::writeProtocol("df-pn: " + std::to_string(result.solverNodes) + " nodes in " +
+                          std::to_string(result.solverTimeMs) + "ms, " +
+                          std::to_string(perSecond(result.solverNodes, result.solverTimeMs)) + " nodes/s, " +
+                          std::to_string(result.collections) + " table collections");
+    Logger::writeProtocol("Reference alpha-beta: " + std::to_string(result.referenceNodes) + " nodes in " +
+                          std::to_string(result.referenceTimeMs) + "ms, " +
+                          std::to_string(perSecond(result.referenceNodes, result.referenceTimeMs)) + " nodes/s");
+    if(PerfCounters::isOpen()) {
+        Logger::writeProtocol("Counters, df-pn: " + result.solverPerf.describe(result.solverNodes));
+        Logger::writeProtocol("Counters, reference: " + result.referencePerf.describe(result.referenceNodes));
+    }
+    Logger::writeProtocol(result.mismatches == 0 ? "OK every proof matches"
+                                                 : "FAILED " + std::to_string(result.mismatches) + " proofs disagree");
+    return result.mismatches == 0;
+}
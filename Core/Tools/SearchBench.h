@@ -0,0 +1,117 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_SEARCHBENCH_H
+#define OTHELLOPROJECT_CPP_SEARCHBENCH_H
+
+#include <cstdint>
+
+#include "../AllocTracker.h"
+#include "../Config.h"
+#include "../PerfCounters.h"
+#include "../Search/SearchParams.h"
+
+class TreeRecorder;
+
+/**
+ * Outcome of a SearchBench run.
+ */
+struct SearchBenchResult {
+    int positions = 0;
+    uint64_t nodes = 0;
+    uint64_t timeMs = 0;
+    SearchStats stats;
+    /**
+     * Sum of the root scores. Changes whenever a parameter change alters a search result.
+     */
+    int64_t scoreSum = 0;
+    /**
+     * Performance counters over the searches, if PerfCounters are open.
+     */
+    PerfSample perf;
+};
+
+/**
+ * Outcome of SearchBench::checkAllocations, per AllocPhase.
+ */
+struct AllocCheckResult {
+    int positions = 0;
+    /**
+     * Allocations during the first search of each position.
+     */
+    AllocCounts warmUp[(int) AllocPhase::Count];
+    /**
+     * Allocations during the repeated search of each position.
+     */
+    AllocCounts measured[(int) AllocPhase::Count];
+};
+
+/**
+ * Outcome of SearchBench::checkSolver.
+ */
+struct SolverCheckResult {
+    int positions = 0;
+    int empties = 0;
+    /**
+     * Outcomes the solver proved, by outcome for the side to move.
+     */
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+    /**
+     * Positions the solver did not prove in time, and proofs that disagree with the reference.
+     */
+    int unknown = 0;
+    int mismatches = 0;
+    uint64_t solverNodes = 0;
+    uint64_t solverTimeMs = 0;
+    int collections = 0;
+    uint64_t referenceNodes = 0;
+    uint64_t referenceTimeMs = 0;
+    /**
+     * Performance counters over the proofs and over the reference searches, if PerfCounters are open.
+     */
+    PerfSample solverPerf;
+    PerfSample referencePerf;
+};
+
+/**
+ * Fixed-depth alpha-beta searches over a reproducible set of positions, for comparing node counts
+ * and pruning statistics between SearchParams settings.
+ */
+class SearchBench {
+public:
+    /**
+     * @param cfg Hash size and SearchParams to benchmark.
+     * @param depth Search depth for every position.
+     * @param positions Number of positions, reached by random moves from the start.
+     * @param seed Seed for the random moves.
+     * @param recorder If not null, the searches are recorded to it (see TreeRecorder).
+     */
+    static SearchBenchResult run(const Config &cfg, int depth, int positions, uint64_t seed = 1,
+                                 TreeRecorder *recorder = nullptr);
+    static void report(const SearchBenchResult &result);
+    /**
+     * Searches every bench position twice, counting heap allocations (see AllocTracker). Needs a
+     * build with OTHELLO_ALLOC_TRACK; otherwise every count is 0.
+     */
+    static AllocCheckResult checkAllocations(const Config &cfg, int depth, int positions, uint64_t seed = 1);
+    /**
+     * @return False if the repeated searches allocated in the tree search.
+     */
+    static bool reportAllocations(const AllocCheckResult &result);
+    /**
+     * Proves random positions with the given number of empty squares with DfpnSolver, and checks
+     * every outcome against a plain alpha-beta search to the end of the game with a (-1, 1) window.
+     * @param timeMs Time for each proof.
+     */
+    static SolverCheckResult checkSolver(const Config &cfg, int empties, int positions, int64_t timeMs,
+                                         uint64_t seed = 1);
+    /**
+     * @return False if a proof disagreed with the reference search.
+     */
+    static bool reportSolver(const SolverCheckResult &result);
+};
+
+#endif //OTHELLOPROJECT_CPP_SEARCHBENCH_H
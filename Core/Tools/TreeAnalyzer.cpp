@@ -0,0 +1,226 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "TreeAnalyzer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+
+#include "../Records/ByteIO.h"
+
+// Records read from the file at a time.
+#define TREE_READ_RECORDS 4096
+
+namespace {
+
+std::string percent(uint64_t part, uint64_t whole) {
+    char text[16];
+    snprintf(text, sizeof(text), "%.1f%%", whole == 0 ? 0.0 : 100.0 * (double) part / (double) whole);
+    return text;
+}
+
+std::string average(uint64_t sum, uint64_t count) {
+    char text[16];
+    snprintf(text, sizeof(text), "%.2f", count == 0 ? 0.0 : (double) sum / (double) count);
+    return text;
+}
+
+std::string describe(const OrderingStats &stats) {
+    std::string cutoffs;
+    for(int i = 0; i < TREE_CUTOFF_SLOTS; i++) {
+        cutoffs += (i == 0 ? "" : " / ") + percent(stats.cutoffAt[i], stats.cutNodes);
+    }
+
+    return std::to_string(stats.nodes) + " nodes, " + average(stats.moves, stats.nodes) + " moves, " +
+           average(stats.subtreeNodes, stats.nodes) + " nodes/subtree; cut " + std::to_string(stats.cutNodes) +
+           " (1st/2nd/3rd/later " + cutoffs + ", mean index " + average(stats.cutoffIndexSum, stats.cutNodes) +
+           "), all " + std::to_string(stats.allNodes) + ", PV " + std::to_string(stats.pvNodes) +
+           " (best first " + percent(stats.pvBestFirst, stats.pvNodes) + ")";
+}
+
+}
+
+void OrderingStats::add(const TreeRecord &record) {
+    this->nodes++;
+    this->moves += record.moveCount;
+    this->subtreeNodes += record.nodes;
+
+    if(record.score >= record.beta) {
+        this->cutNodes++;
+        this->cutoffAt[std::min<int>(record.bestIndex, TREE_CUTOFF_SLOTS - 1)]++;
+        this->cutoffIndexSum += record.bestIndex;
+    } else if(record.score <= record.alpha) {
+        this->allNodes++;
+    } else {
+        this->pvNodes++;
+        this->pvBestFirst += record.bestIndex == 0;
+    }
+}
+
+double OrderingStats::firstCutRate() const {
+    return this->cutNodes == 0 ? 0 : 100.0 * (double) this->cutoffAt[0] / (double) this->cutNodes;
+}
+
+TreeAnalysis TreeAnalyzer::analyze(const std::string &path) {
+    TreeAnalysis analysis;
+
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if(file == nullptr) {
+        analysis.error = "cannot read " + path;
+        return analysis;
+    }
+
+    uint8_t header[TreeRecorder::HEADER_SIZE];
+    if(std::fread(header, 1, sizeof(header), file) != sizeof(header) ||
+       ByteIO::getU32(header) != TreeRecorder::MAGIC || ByteIO::getU32(header + 4) != TreeRecorder::VERSION ||
+       ByteIO::getU32(header + 8) != TreeRecorder::RECORD_SIZE) {
+        std::fclose(file);
+        analysis.error = path + " is not a search tree file of this version";
+        return analysis;
+    }
+
+    // The previous record at each ply. A repeated search of a node comes right after the first one
+    // at the same ply, since everything in between is deeper.
+    std::vector<TreeRecord> lastAtPly(256);
+    std::vector<bool> seenAtPly(256, false);
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[TREE_READ_RECORDS * TreeRecorder::RECORD_SIZE]);
+
+    size_t count;
+    while((count = std::fread(buffer.get(), TreeRecorder::RECORD_SIZE, TREE_READ_RECORDS, file)) > 0) {
+        for(size_t i = 0; i < count; i++) {
+            TreeRecord record = TreeRecorder::decode(buffer.get() + i * TreeRecorder::RECORD_SIZE);
+            analysis.records++;
+
+            if(record.search >= analysis.searches.size()) {
+                analysis.searches.resize(record.search + 1);
+                analysis.searches[record.search].search = record.search;
+            }
+            SearchSummary &summary = analysis.searches[record.search];
+
+            if(record.flags & TREE_FLAG_REDUCED) {
+                analysis.reducedSearches++;
+            }
+            if(record.flags & TREE_FLAG_RESEARCH) {
+                const TreeRecord &first = lastAtPly[record.ply];
+                if(seenAtPly[record.ply] && first.key == record.key && first.search == record.search) {
+                    bool reduced = (first.flags & TREE_FLAG_REDUCED) != 0;
+                    (reduced ? analysis.reducedResearched : analysis.nullWindowResearched)++;
+                    (reduced ? analysis.reducedWastedNodes : analysis.nullWindowWastedNodes) += first.nodes;
+                }
+            }
+            lastAtPly[record.ply] = record;
+            seenAtPly[record.ply] = true;
+
+            if(record.ply == 0) {
+                summary.empties = record.empties;
+                summary.depth = std::max<int>(summary.depth, record.iteration);
+                summary.nodes += record.nodes;
+            }
+
+            if(record.flags & TREE_FLAG_LEAF) {
+                analysis.leaves++;
+                continue;
+            }
+            if(record.flags & (TREE_FLAG_TT_CUTOFF | TREE_FLAG_ETC_CUTOFF)) {
+                (record.flags & TREE_FLAG_TT_CUTOFF ? analysis.ttCutoffs : analysis.etcCutoffs)++;
+                continue;
+            }
+            if(record.bestIndex == TREE_NO_INDEX) {
+                continue;
+            }
+
+            if(record.ply >= analysis.byPly.size()) {
+                analysis.byPly.resize(record.ply + 1);
+            }
+            analysis.byPly[record.ply].add(record);
+            analysis.byPhase[(int) getPhase(record.empties)].add(record);
+            int source = record.flags & TREE_FLAG_PV_MOVE ? 0 : record.flags & TREE_FLAG_TT_MOVE ? 1 : 2;
+            analysis.byFirstMove[source].add(record);
+            summary.ordering.add(record);
+        }
+    }
+
+    bool truncated = std::ferror(file) || std::ftell(file) != (long) (TreeRecorder::HEADER_SIZE +
+                                                                      analysis.records * TreeRecorder::RECORD_SIZE);
+    std::fclose(file);
+    if(truncated) {
+        analysis.error = path + " ends in a partial record";
+        return analysis;
+    }
+
+    analysis.valid = true;
+    return analysis;
+}
+
+std::vector<std::string> TreeAnalyzer::format(const TreeAnalysis &analysis, int topSearches) {
+    std::vector<std::string> lines;
+    if(!analysis.valid) {
+        lines.push_back(analysis.error);
+        return lines;
+    }
+
+    lines.push_back(std::to_string(analysis.records) + " nodes in " + std::to_string(analysis.searches.size()) +
+                    " searches: " + std::to_string(analysis.leaves) + " leaves, " +
+                    std::to_string(analysis.ttCutoffs) + " table cutoffs, " + std::to_string(analysis.etcCutoffs) +
+                    " ETC cutoffs");
+
+    for(size_t ply = 0; ply < analysis.byPly.size(); ply++) {
+        if(analysis.byPly[ply].nodes > 0) {
+            lines.push_back("Ply " + std::to_string(ply) + ": " + describe(analysis.byPly[ply]));
+        }
+    }
+    for(int phase = 0; phase < (int) GamePhase::Count; phase++) {
+        if(analysis.byPhase[phase].nodes > 0) {
+            lines.push_back(std::string(getPhaseName((GamePhase) phase)) + ": " + describe(analysis.byPhase[phase]));
+        }
+    }
+
+    const char *sources[3] = { "PV move first", "Table move first", "Static order" };
+    for(int source = 0; source < 3; source++) {
+        if(analysis.byFirstMove[source].nodes > 0) {
+            lines.push_back(std::string(sources[source]) + ": " + describe(analysis.byFirstMove[source]));
+        }
+    }
+
+    lines.push_back("Re-searches: " + std::to_string(analysis.reducedResearched) + " of " +
+                    std::to_string(analysis.reducedSearches) + " reduced searches (" +
+                    std::to_string(analysis.reducedWastedNodes) + " nodes), " +
+                    std::to_string(analysis.nullWindowResearched) + " null-window searches (" +
+                    std::to_string(analysis.nullWindowWastedNodes) + " nodes)");
+
+    std::vector<const SearchSummary *> largest;
+    for(const SearchSummary &summary : analysis.searches) {
+        largest.push_back(&summary);
+    }
+    size_t shown = std::min(largest.size(), (size_t) std::max(0, topSearches));
+    std::partial_sort(largest.begin(), largest.begin() + (long) shown, largest.end(),
+                      [](const SearchSummary *a, const SearchSummary *b) { return a->nodes > b->nodes; });
+    for(size_t i = 0; i < shown; i++) {
+        const SearchSummary &summary = *largest[i];
+        char rate[16];
+        snprintf(rate, sizeof(rate), "%.1f%%", summary.ordering.firstCutRate());
+        lines.push_back("Search " + std::to_string(summary.search) + ": " + std::to_string(summary.nodes) +
+                        " nodes to depth " + std::to_string(summary.depth) + " with " +
+                        std::to_string(summary.empties) + " empties, first-move cutoffs " + rate);
+    }
+    return lines;
+}
+
+GamePhase TreeAnalyzer::getPhase(int empties) {
+    return empties >= 44 ? GamePhase::Opening : empties >= 20 ? GamePhase::Midgame : GamePhase::Endgame;
+}
+
+const char *TreeAnalyzer::getPhaseName(GamePhase phase) {
+    switch(phase) {
+        case GamePhase::Opening:
+            return "Opening";
+        case GamePhase::Midgame:
+            return "Midgame";
+        case GamePhase::Endgame:
+            return "Endgame";
+        default:
+            return "unknown";
+    }
+}
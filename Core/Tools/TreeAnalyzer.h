@@ -0,0 +1,126 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_TREEANALYZER_H
+#define OTHELLOPROJECT_CPP_TREEANALYZER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Search/TreeRecorder.h"
+
+// Cutoff positions counted separately: first, second, third and any later move.
+#define TREE_CUTOFF_SLOTS 4
+
+enum class GamePhase {
+    /**
+     * At least 44 empty squares.
+     */
+    Opening,
+    Midgame,
+    /**
+     * Fewer than 20 empty squares.
+     */
+    Endgame,
+    Count
+};
+
+/**
+ * Move ordering figures over a group of recorded nodes. Only nodes that searched moves count;
+ * leaves and table cutoffs have no ordering.
+ */
+struct OrderingStats {
+    uint64_t nodes = 0;
+    /**
+     * Nodes that failed high, and in which position of the search order the cutoff came.
+     */
+    uint64_t cutNodes = 0;
+    uint64_t cutoffAt[TREE_CUTOFF_SLOTS] = {};
+    uint64_t cutoffIndexSum = 0;
+    /**
+     * Nodes that failed low, i.e. searched every move without raising alpha.
+     */
+    uint64_t allNodes = 0;
+    /**
+     * Nodes with an exact score, and how many of them found it with the first move.
+     */
+    uint64_t pvNodes = 0;
+    uint64_t pvBestFirst = 0;
+    /**
+     * Moves available at the nodes, and subtree sizes.
+     */
+    uint64_t moves = 0;
+    uint64_t subtreeNodes = 0;
+
+    void add(const TreeRecord &record);
+    /**
+     * @return Share of cut nodes cut off by their first move, in percent.
+     */
+    double firstCutRate() const;
+};
+
+/**
+ * Subtree sizes of one recorded search, to find the ones that blew up.
+ */
+struct SearchSummary {
+    uint32_t search = 0;
+    int empties = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    OrderingStats ordering;
+};
+
+/**
+ * Outcome of TreeAnalyzer::analyze.
+ */
+struct TreeAnalysis {
+    /**
+     * False if the file could not be read or is not a tree file; error says why.
+     */
+    bool valid = false;
+    std::string error;
+    uint64_t records = 0;
+    uint64_t leaves = 0;
+    uint64_t ttCutoffs = 0;
+    uint64_t etcCutoffs = 0;
+
+    std::vector<OrderingStats> byPly;
+    OrderingStats byPhase[(int) GamePhase::Count];
+    /**
+     * By where the first move came from: the principal variation, the table, or the static order.
+     */
+    OrderingStats byFirstMove[3];
+
+    /**
+     * Searches that had to be repeated: reduced searches that failed high, and null-window searches
+     * that beat the best move. Their nodes were spent again by the repeated search.
+     */
+    uint64_t reducedSearches = 0;
+    uint64_t reducedResearched = 0;
+    uint64_t reducedWastedNodes = 0;
+    uint64_t nullWindowResearched = 0;
+    uint64_t nullWindowWastedNodes = 0;
+
+    std::vector<SearchSummary> searches;
+};
+
+/**
+ * Offline analysis of files written by TreeRecorder: where in the move order cutoffs happen, by ply,
+ * by game phase and by where the first move came from, how many nodes went into searches that had
+ * to be repeated, and which searches were the largest.
+ */
+class TreeAnalyzer {
+public:
+    static TreeAnalysis analyze(const std::string &path);
+    /**
+     * @param topSearches Number of the largest searches to list.
+     * @return The analysis as text lines.
+     */
+    static std::vector<std::string> format(const TreeAnalysis &analysis, int topSearches = 5);
+    static GamePhase getPhase(int empties);
+    static const char *getPhaseName(GamePhase phase);
+};
+
+#endif //OTHELLOPROJECT_CPP_TREEANALYZER_H
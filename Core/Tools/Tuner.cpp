@@ -0,0 +1,182 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "Tuner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+
+#include "Match.h"
+#include "../Bits.h"
+#include "../Logger.h"
+#include "../OthelloGame/OthelloGameBoard.h"
+
+// Standard SPSA gain exponents: a_k = a / (k + A)^ALPHA, c_k = c / k^GAMMA.
+#define SPSA_ALPHA 0.602
+#define SPSA_GAMMA 0.101
+// Perturbation at the first iteration, in ParamSpec steps.
+#define SPSA_C 1.0
+// Move at the first iteration for a 60% match score, in ParamSpec steps.
+#define SPSA_FIRST_MOVE 0.5
+
+namespace {
+
+struct Opening {
+    uint64_t black;
+    uint64_t white;
+    int sideToMove;
+};
+
+// A few random moves from the start, so that games between near-identical settings differ.
+Opening randomOpening(std::mt19937_64 &rng) {
+    Opening opening = { 0x0000000810000000ULL, 0x0000001008000000ULL, BLACK };
+    int plies = 4 + (int) (rng() % 7);
+
+    for(int ply = 0; ply < plies; ply++) {
+        uint64_t &own = opening.sideToMove == BLACK ? opening.black : opening.white;
+        uint64_t &other = opening.sideToMove == BLACK ? opening.white : opening.black;
+        uint64_t legal = OthelloGameBoard::generateMoveMask(own, other);
+        if(legal == 0) {
+            break;
+        }
+
+        for(int k = (int) (rng() % (uint64_t) Bits::popcount(legal)); k > 0; k--) {
+            legal = Bits::clearLowest(legal);
+        }
+        int pos = Bits::lowest(legal);
+        uint64_t flips = OthelloGameBoard::getFlips(own, other, pos);
+        own |= flips | (1ULL << pos);
+        other &= ~flips;
+        opening.sideToMove = -opening.sideToMove;
+    }
+
+    return opening;
+}
+
+SearchParams toParams(const SearchParams &base, const std::vector<ParamSpec> &specs, const std::vector<double> &x) {
+    SearchParams params = base;
+    for(size_t i = 0; i < specs.size(); i++) {
+        params.*specs[i].field = (int) std::lround(x[i] * specs[i].step);
+    }
+    params.clamp();
+    return params;
+}
+
+std::string describe(const SearchParams &params, const std::vector<ParamSpec> &specs) {
+    std::string s;
+    for(const ParamSpec &spec : specs) {
+        s += std::string(s.empty() ? "" : " ") + spec.name + "=" + std::to_string(params.*spec.field);
+    }
+    return s;
+}
+
+}
+
+SearchParams Tuner::run(const Config &cfg, const TunerOptions &options) {
+    std::vector<ParamSpec> specs;
+    for(const ParamSpec &spec : SearchParams::getSpecs()) {
+        if(options.params.empty() ||
+           std::find(options.params.begin(), options.params.end(), spec.name) != options.params.end()) {
+            specs.push_back(spec);
+        }
+    }
+
+    // Parameters are tuned in units of their step, so that one gain sequence fits all of them.
+    SearchParams best = cfg.getSearchParams();
+    std::vector<double> x;
+    for(const ParamSpec &spec : specs) {
+        x.push_back((double) (best.*spec.field) / spec.step);
+    }
+
+    // Gains such that a 60% score moves every parameter SPSA_FIRST_MOVE steps in the first iteration.
+    double bigA = 0.1 * options.iterations;
+    double firstGradient = (2 * 0.6 - 1) / (2 * SPSA_C);
+    double a = SPSA_FIRST_MOVE / firstGradient * std::pow(bigA + 1, SPSA_ALPHA);
+
+    int threads = options.threads > 0 ? options.threads : (int) std::max(1u, std::thread::hardware_concurrency());
+    int games = 2 * options.pairs;
+    std::mt19937_64 rng(options.seed);
+
+    Logger::writeProtocol("Tuning " + std::to_string(specs.size()) + " parameters, " +
+                          std::to_string(options.iterations) + " iterations of " + std::to_string(games) +
+                          " games on " + std::to_string(threads) + " threads: " + describe(best, specs));
+
+    // Thousands of searches would each log their iterations.
+    LogLevel level = Logger::getLevel();
+    Logger::setLevel(LogLevel::Warn);
+
+    for(int k = 1; k <= options.iterations; k++) {
+        double ck = SPSA_C / std::pow(k, SPSA_GAMMA);
+        double ak = a / std::pow(k + bigA, SPSA_ALPHA);
+
+        std::vector<int> delta;
+        std::vector<double> xPlus = x, xMinus = x;
+        for(size_t i = 0; i < x.size(); i++) {
+            delta.push_back(rng() & 1 ? 1 : -1);
+            xPlus[i] += ck * delta[i];
+            xMinus[i] -= ck * delta[i];
+        }
+
+        Config plus = cfg, minus = cfg;
+        plus.setSearchParams(toParams(best, specs, xPlus));
+        minus.setSearchParams(toParams(best, specs, xMinus));
+
+        std::vector<Opening> openings;
+        for(int i = 0; i < options.pairs; i++) {
+            openings.push_back(randomOpening(rng));
+        }
+
+        // Even games give plus the side to move first, odd games the other side.
+        std::vector<int> plusDiff(games);
+        std::atomic<int> next(0);
+        auto worker = [&] {
+            for(int game; (game = next.fetch_add(1)) < games;) {
+                const Opening &opening = openings[game / 2];
+                bool plusBlack = (opening.sideToMove == BLACK) == (game % 2 == 0);
+                int diff = Match::playGame(plusBlack ? plus : minus, plusBlack ? minus : plus,
+                                           opening.black, opening.white, opening.sideToMove);
+                plusDiff[game] = plusBlack ? diff : -diff;
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for(int t = 1; t < std::min(threads, games); t++) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for(std::thread &thread : pool) {
+            thread.join();
+        }
+
+        double points = 0;
+        for(int diff : plusDiff) {
+            points += diff > 0 ? 1 : diff == 0 ? 0.5 : 0;
+        }
+        double score = points / games;
+
+        // The minus side scored 1 - score, so the difference of the two is 2 * score - 1.
+        for(size_t i = 0; i < x.size(); i++) {
+            double gradient = (2 * score - 1) / (2 * ck * delta[i]);
+            double low = (double) specs[i].min / specs[i].step;
+            double high = (double) specs[i].max / specs[i].step;
+            x[i] = std::max(low, std::min(high, x[i] + ak * gradient));
+        }
+
+        best = toParams(best, specs, x);
+        std::string comment = "SPSA iteration " + std::to_string(k) + " of " + std::to_string(options.iterations);
+        if(!best.save(options.output, comment)) {
+            Logger::log(LogLevel::Error, "Could not write " + options.output);
+        }
+
+        Logger::writeProtocol("Iteration " + std::to_string(k) + "/" + std::to_string(options.iterations) +
+                              ": plus scored " + std::to_string((int) std::lround(score * 100)) + "%, " +
+                              describe(best, specs));
+    }
+
+    Logger::setLevel(level);
+    return best;
+}
@@ -0,0 +1,56 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_TUNER_H
+#define OTHELLOPROJECT_CPP_TUNER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Config.h"
+#include "../Search/SearchParams.h"
+
+struct TunerOptions {
+    int iterations = 100;
+    /**
+     * Openings per iteration. Each is played twice, with colors swapped.
+     */
+    int pairs = 8;
+    /**
+     * Games played at once, 0 for one per core.
+     */
+    int threads = 0;
+    /**
+     * Names of the parameters to tune (see SearchParams::getSpecs), empty for all of them.
+     */
+    std::vector<std::string> params;
+    /**
+     * The current parameter set is written here after every iteration.
+     */
+    std::string output = "tuned.params";
+    uint64_t seed = 1;
+};
+
+/**
+ * SPSA tuner for SearchParams.
+ *
+ * Every iteration perturbs all tuned parameters at once by +-c_k steps (ParamSpec::step) in random
+ * directions and plays the two resulting sets against each other in fast in-process games. The
+ * match score is the gradient estimate for every parameter at once, so an iteration costs the same
+ * number of games however many parameters are tuned. Step sizes shrink with the usual SPSA gain
+ * sequences. The games are played on a clock of the Config's game time (see Match::playGame), so a
+ * short game time makes them fast. Each side of every game running at once holds a transposition
+ * table of the Config's hash size and a proof-number solver.
+ */
+class Tuner {
+public:
+    /**
+     * @param cfg Starting parameters and game time.
+     * @return The tuned parameters, also written to options.output.
+     */
+    static SearchParams run(const Config &cfg, const TunerOptions &options);
+};
+
+#endif //OTHELLOPROJECT_CPP_TUNER_H
@@ -0,0 +1,194 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#include "Trace.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#include <unistd.h>
+
+// Events per buffer chunk. Chunks are only allocated by threads that record something.
+#define TRACE_CHUNK_EVENTS 512
+// Each thread keeps at most this many chunks; later events are counted and dropped.
+#define TRACE_MAX_CHUNKS 2048
+
+namespace {
+
+struct Event {
+    const char *name;
+    const char *argName;
+    int64_t arg;
+    uint64_t startNs;
+    uint64_t endNs;
+};
+
+/**
+ * Written by its thread only. The dumper may read it concurrently: events below count are complete.
+ */
+struct Chunk {
+    Event events[TRACE_CHUNK_EVENTS];
+    std::atomic<size_t> count{0};
+    std::atomic<Chunk *> next{nullptr};
+};
+
+struct ThreadBuffer {
+    uint32_t tid = 0;
+    std::atomic<const char *> name{nullptr};
+    Chunk *head = nullptr;
+    Chunk *tail = nullptr;
+    size_t chunks = 0;
+    std::atomic<uint64_t> dropped{0};
+};
+
+std::mutex g_registryMutex;
+std::string g_path;
+uint64_t g_epochNs = 0;
+
+// Never destroyed: threads may still record while static destructors run at exit.
+std::vector<ThreadBuffer *> &registry() {
+    static auto *buffers = new std::vector<ThreadBuffer *>();
+    return *buffers;
+}
+
+thread_local ThreadBuffer *t_buffer = nullptr;
+// Kept separately so that naming a thread does not allocate a buffer for it.
+thread_local const char *t_name = nullptr;
+
+ThreadBuffer &threadBuffer() {
+    if(t_buffer == nullptr) {
+        auto *buffer = new ThreadBuffer();
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        buffer->tid = (uint32_t) registry().size() + 1;
+        buffer->name.store(t_name, std::memory_order_release);
+        registry().push_back(buffer);
+        t_buffer = buffer;
+    }
+    return *t_buffer;
+}
+
+void dumpAtExit() {
+    Trace::dump();
+}
+
+}
+
+std::atomic<bool> Trace::s_enabled(false);
+
+void Trace::start(const std::string &path) {
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        g_path = path;
+        g_epochNs = now();
+    }
+
+    if(!s_enabled.exchange(true)) {
+        std::atexit(dumpAtExit);
+    }
+}
+
+void Trace::setThreadName(const char *name) {
+    t_name = name;
+    if(t_buffer != nullptr) {
+        t_buffer->name.store(name, std::memory_order_release);
+    }
+}
+
+void Trace::record(const char *name, const char *argName, int64_t arg, uint64_t startNs, uint64_t endNs) {
+    ThreadBuffer &buffer = threadBuffer();
+
+    Chunk *chunk = buffer.tail;
+    size_t count = chunk == nullptr ? TRACE_CHUNK_EVENTS : chunk->count.load(std::memory_order_relaxed);
+    if(count == TRACE_CHUNK_EVENTS) {
+        if(buffer.chunks == TRACE_MAX_CHUNKS) {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        auto *next = new Chunk();
+        if(chunk == nullptr) {
+            // Publishing head is ordered by the registry mutex, which the dumper also takes.
+            std::lock_guard<std::mutex> lock(g_registryMutex);
+            buffer.head = next;
+        } else {
+            chunk->next.store(next, std::memory_order_release);
+        }
+        buffer.tail = next;
+        buffer.chunks++;
+        chunk = next;
+        count = 0;
+    }
+
+    chunk->events[count] = { name, argName, arg, startNs, endNs };
+    chunk->count.store(count + 1, std::memory_order_release);
+}
+
+bool Trace::dump() {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    if(g_path.empty()) {
+        return false;
+    }
+
+    std::FILE *file = std::fopen(g_path.c_str(), "w");
+    if(file == nullptr) {
+        return false;
+    }
+
+    int pid = (int) getpid();
+    bool first = true;
+    auto separator = [&] {
+        std::fputs(first ? "\n" : ",\n", file);
+        first = false;
+    };
+
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+    for(ThreadBuffer *buffer : registry()) {
+        const char *name = buffer->name.load(std::memory_order_acquire);
+        if(name != nullptr) {
+            separator();
+            std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                         pid, buffer->tid, name);
+        }
+
+        for(Chunk *chunk = buffer->head; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire)) {
+            size_t count = chunk->count.load(std::memory_order_acquire);
+            for(size_t i = 0; i < count; i++) {
+                const Event &event = chunk->events[i];
+                // Events from before start() (a scope that was already open) are clamped to it.
+                uint64_t start = event.startNs > g_epochNs ? event.startNs - g_epochNs : 0;
+                uint64_t end = event.endNs > g_epochNs ? event.endNs - g_epochNs : 0;
+
+                separator();
+                std::fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+                             event.name, pid, buffer->tid, start / 1000.0, (end - start) / 1000.0);
+                if(event.argName != nullptr) {
+                    std::fprintf(file, ",\"args\":{\"%s\":%" PRId64 "}", event.argName, event.arg);
+                }
+                std::fputs("}", file);
+            }
+        }
+
+        uint64_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+        if(dropped > 0) {
+            separator();
+            std::fprintf(file, "{\"name\":\"events dropped\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%u,"
+                               "\"ts\":%.3f,\"args\":{\"count\":%" PRIu64 "}}",
+                         pid, buffer->tid, (now() - g_epochNs) / 1000.0, dropped);
+        }
+    }
+    std::fputs("\n]}\n", file);
+
+    return std::fclose(file) == 0;
+}
+
+bool Trace::isCompiledIn() {
+#ifdef OTHELLO_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
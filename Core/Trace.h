@@ -0,0 +1,102 @@
+//
+// Created by hburn7 on 10/19/26.
+//
+
+#ifndef OTHELLOPROJECT_CPP_TRACE_H
+#define OTHELLOPROJECT_CPP_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * Timeline profiler writing Chrome trace-event JSON (chrome://tracing, Perfetto).
+ *
+ * Scoped events are recorded into a buffer owned by the recording thread, so recording takes no
+ * lock and never waits on another thread. Buffers are chunked and survive their thread, and the
+ * whole timeline is written out when the process exits (or on dump()).
+ *
+ * Instrumentation goes through TRACE_SCOPE / TRACE_SCOPE_ARG, which compile away entirely unless
+ * OTHELLO_TRACE is defined. With it defined, nothing is recorded until start() has been called,
+ * and a scope costs a relaxed load when tracing is off.
+ */
+class Trace {
+public:
+    /**
+     * Starts recording. The trace is written to path at exit.
+     */
+    static void start(const std::string &path);
+    static inline bool isEnabled() {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+    /**
+     * Names the calling thread in the timeline. Cheap, and may be called before start().
+     * @param name A string literal (or otherwise outlives the trace).
+     */
+    static void setThreadName(const char *name);
+    /**
+     * Records a completed event on the calling thread.
+     * @param name A string literal.
+     * @param argName A string literal naming arg, or nullptr for none.
+     */
+    static void record(const char *name, const char *argName, int64_t arg, uint64_t startNs, uint64_t endNs);
+    /**
+     * Writes everything recorded so far to the path given to start().
+     * @return False on I/O failure, or if tracing was never started.
+     */
+    static bool dump();
+    /**
+     * @return Nanoseconds since the trace clock's epoch.
+     */
+    static inline uint64_t now() {
+        return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    /**
+     * @return True if this build records events, i.e. OTHELLO_TRACE is defined.
+     */
+    static bool isCompiledIn();
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * Records the lifetime of a scope as one event.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char *name, const char *argName = nullptr, int64_t arg = 0) :
+            m_name(name), m_argName(argName), m_arg(arg), m_start(Trace::isEnabled() ? Trace::now() : 0) {}
+
+    ~TraceScope() {
+        if(m_start != 0) {
+            Trace::record(m_name, m_argName, m_arg, m_start, Trace::now());
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *m_name;
+    const char *m_argName;
+    int64_t m_arg;
+    uint64_t m_start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef OTHELLO_TRACE
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_SCOPE_ARG(name, argName, arg) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, argName, (int64_t) (arg))
+#define TRACE_THREAD_NAME(name) Trace::setThreadName(name)
+#else
+#define TRACE_SCOPE(name) do { } while(0)
+#define TRACE_SCOPE_ARG(name, argName, arg) do { } while(0)
+#define TRACE_THREAD_NAME(name) do { } while(0)
+#endif
+
+#endif //OTHELLOPROJECT_CPP_TRACE_H
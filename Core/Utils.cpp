@@ -4,6 +4,11 @@
 
 #include "Utils.h"
 
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <string.h>
+
 int Utils::getColFromChar(char col) {
     switch(col) {
         case 'a': return 0;
@@ -38,3 +43,57 @@ std::tuple<int, char> Utils::posToRowCol(int pos) {
 
     return std::tuple<int, char>(row + 1, c);
 }
+
+std::string Utils::posToSquare(int pos) {
+    if(pos < 0 || pos > 63) {
+        return "pass";
+    }
+
+    std::tuple<int, char> rowCol = posToRowCol(pos);
+    return std::string(1, std::get<1>(rowCol)) + std::to_string(std::get<0>(rowCol));
+}
+
+int Utils::squareToPos(const std::string &square) {
+    if(square == "pass") {
+        return -1;
+    }
+
+    if(square.length() != 2 || getColFromChar(square[0]) < 0 || square[1] < '1' || square[1] > '8') {
+        return -2;
+    }
+
+    // Same mapping as OutputHandler::toMove: a1 is 63, h8 is 0.
+    return (8 - (square[1] - '0')) * 8 + 7 - getColFromChar(square[0]);
+}
+
+const char *Utils::getOption(int argc, char *argv[], const std::string &name) {
+    for(int i = 1; i < argc; i++) {
+        if(strncmp(argv[i], name.c_str(), name.length()) == 0 && argv[i][name.length()] == '=') {
+            return argv[i] + name.length() + 1;
+        }
+    }
+
+    return nullptr;
+}
+
+bool Utils::hasFlag(int argc, char *argv[], const std::string &name) {
+    for(int i = 1; i < argc; i++) {
+        if(name == argv[i]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Utils::parseInt(const char *text, int &value) {
+    char *end;
+    errno = 0;
+    long parsed = strtol(text, &end, 10);
+    if(end == text || *end != '\0' || errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX) {
+        return false;
+    }
+
+    value = (int) parsed;
+    return true;
+}
@@ -24,6 +24,32 @@ public:
      * @return A tuple containing the row as an integer and the column as a char.
      */
     static std::tuple<int, char> posToRowCol(int pos);
+    /**
+     * @param pos The integer position on the bitboard, or -1 for a pass.
+     * @return The square in "d3" notation, or "pass".
+     */
+    static std::string posToSquare(int pos);
+    /**
+     * Parses a square in "d3" notation, or "pass".
+     * @return The position on the bitboard, -1 for a pass, or -2 if the text is not a square.
+     */
+    static int squareToPos(const std::string &square);
+    /**
+     * Looks up a "--name=value" style command line option.
+     * @param name The option name, including the leading dashes.
+     * @return The text following '=', or nullptr if the option was not given.
+     */
+    static const char *getOption(int argc, char *argv[], const std::string &name);
+    /**
+     * @param name The flag name, including the leading dashes.
+     * @return True if the flag was given on its own, without a value.
+     */
+    static bool hasFlag(int argc, char *argv[], const std::string &name);
+    /**
+     * Parses a whole string as a decimal integer.
+     * @return False, leaving value unchanged, if the text is empty, has anything after the number or is out of range.
+     */
+    static bool parseInt(const char *text, int &value);
 };
 
 